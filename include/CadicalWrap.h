@@ -0,0 +1,44 @@
+#ifndef LEXIMAXIST_CADICALWRAP
+#define LEXIMAXIST_CADICALWRAP
+
+#include <IpasirWrap.h>
+#include <string>
+
+namespace CaDiCaL {
+    class Solver;
+    class Terminator;
+}
+
+namespace leximaxIST {
+    // SAT solver CaDiCaL used through its C++ API, with the controls that IPASIR does not offer
+    class CadicalWrap : public IpasirWrap {
+    public:
+        /* preset is a configuration of CaDiCaL, applied before any clause is added:
+         * "sat" for the searches that mostly find solutions, "unsat" for the ones that mostly prove bounds,
+         * or empty for the default configuration
+         */
+        CadicalWrap(const std::string &preset = "");
+        virtual ~CadicalWrap();
+        
+        void phase(int lit) override;
+        void unphase(int lit) override;
+        void freeze(int lit) override;
+        void melt(int lit) override;
+        void set_limits(int conflicts, int decisions) override;
+        void simplify() override;
+        
+    protected:
+        void add_lit(int lit) override;
+        void assume(int lit) override;
+        int sat_solve() override;
+        int val(int var) override;
+        bool failed(int lit) override;
+        IpasirWrap* copy_solver() const override;
+        
+    private:
+        CaDiCaL::Solver *_solver;
+        CaDiCaL::Terminator *_terminator; // calls must_stop
+    };
+
+} /* namespace leximaxIST */
+#endif /* LEXIMAXIST_CADICALWRAP */
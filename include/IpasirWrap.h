@@ -9,15 +9,23 @@
 #define LEXIMAXIST_IPASIRWRAP
 
 #include <leximaxIST_types.h>
+#include <leximaxIST_ClauseSet.h>
 #include <vector>
+#include <atomic>
 
 namespace leximaxIST {
+    /* SAT solver used through the IPASIR interface
+     * it is also the base class of the backends that use the API of a specific SAT solver (see CadicalWrap):
+     * these override the protected functions that call the SAT solver, and the controls that IPASIR does not offer
+     */
     class IpasirWrap {
     public:
         IpasirWrap();
         virtual ~IpasirWrap();
         void addClauses(const std::vector<Clause> &cls);
-        void addClause(const Clause &clause);
+        void addClauses(const ClauseSet &cls);
+        void addClause(ClauseRef clause);
+        void addClause(ClauseRef clause, int lit); // clause with lit (e.g., the negation of an activation literal)
         void addClause(int p);
         void addClause(int p, int q);
         void addClause(int p, int q, int r);
@@ -26,6 +34,14 @@ namespace leximaxIST {
         bool is_ok_lit(int l);
         // return a non-const reference to be able to steal _model's data with move semantics
         std::vector<int>& model();
+        
+        /* the models only have the values of the variables 1..nb_vars, so that reading a model does not depend
+         * on the size of the encodings (all the variables if nb_vars is 0)
+         */
+        void set_projection(int nb_vars);
+        
+        // value of any variable (var or -var) in the last model, read from the SAT solver when it is needed
+        int value(int var);
         const std::vector<int>& conflict() const;
 
         /* set a timeout (in seconds) counting from when this function is called
@@ -33,6 +49,12 @@ namespace leximaxIST {
          */
         void set_timeout(double timeout, double init_time);
         
+        // interrupt the SAT solver as soon as *stop is true
+        void set_stop(const std::atomic<bool> *stop);
+        
+        // interrupt the SAT solver as soon as *cancel is true (the solver was terminated by the user)
+        void set_cancel(const std::atomic<bool> *cancel);
+        
         int nVars() const;
 
         /* Returns the return value of the ipasir function:
@@ -43,18 +65,53 @@ namespace leximaxIST {
         int solve(const std::vector<int>& assumps);
         int solve();
         
+        // true if the SAT solver must be interrupted (stop or cancel flag set, or timeout reached)
+        bool must_stop() const;
+        
+        /* controls of the SAT solver, ignored if the backend does not offer them (IPASIR does not)
+         * phase: the SAT solver decides on lit first, until unphase is called for its variable
+         * freeze: the variable of lit is not eliminated by inprocessing until melt is called as many times as freeze
+         * set_limits: limits of the next call of solve, which returns 0 when a limit is reached (no limit if negative)
+         * simplify: runs the preprocessing of the SAT solver, without searching
+         */
+        virtual void phase(int lit);
+        virtual void unphase(int lit);
+        virtual void freeze(int lit);
+        virtual void melt(int lit);
+        virtual void set_limits(int conflicts, int decisions);
+        virtual void simplify();
+        
+        /* new SAT solver with the clauses of this one, so that it has the same models, without the learnt clauses
+         * the copy has neither the stop flags, the timeout nor the projection of this one
+         * only the backends that can copy their SAT solver implement it (IPASIR can not, the program is terminated)
+         */
+        IpasirWrap* copy() const;
+        
+    protected:
+        IpasirWrap(bool ipasir); // if ipasir is false, there is no IPASIR solver (the backend has one of its own)
+        
+        // the calls to the SAT solver
+        virtual void add_lit(int lit); // 0 terminates the clause
+        virtual void assume(int lit);
+        virtual int sat_solve(); // the return value of the ipasir function
+        virtual int val(int var);
+        virtual bool failed(int lit);
+        virtual IpasirWrap* copy_solver() const;
+        
     private:
         //const int           _verb = 1;
         int                _nvars;
+        int                _projection;
         void*              _s;
         std::vector<int> _model;
         std::vector<int> _conflict;
-    public:
+        
         struct TimeParams {
-            double m_timeout;
+            double m_timeout; // no timeout if not positive
             double m_init_time;
+            const std::atomic<bool> *m_stop;
+            const std::atomic<bool> *m_cancel;
         };
-    private:
         TimeParams _time_params;
 
         void add(int p);
@@ -0,0 +1,91 @@
+#ifndef LEXIMAXIST_CLAUSESET
+#define LEXIMAXIST_CLAUSESET
+#include <leximaxIST_types.h>
+#include <cstddef>
+#include <vector>
+
+namespace leximaxIST {
+
+    // read-only view of the literals of a clause, either of a Clause or of a clause in a ClauseSet
+    class ClauseRef {
+    public:
+        ClauseRef(const int *begin, const int *end) : m_begin(begin), m_end(end) {}
+
+        ClauseRef(const Clause &cl) : m_begin(cl.data()), m_end(cl.data() + cl.size()) {}
+
+        const int* begin() const { return m_begin; }
+        const int* end() const { return m_end; }
+        size_t size() const { return m_end - m_begin; }
+        bool empty() const { return m_begin == m_end; }
+        int operator[](size_t j) const { return m_begin[j]; }
+
+    private:
+        const int *m_begin;
+        const int *m_end;
+    }; // ClauseRef definition
+
+    /* set of clauses stored contiguously (CSR layout): the literals of all the clauses in a single vector
+     * and, for each clause, the position where it starts. The ith clause ends where the (i+1)th starts.
+     * Adding a clause does not allocate memory, except when the vectors grow.
+     * If the set does not retain its clauses, they are only counted (see set_retain).
+     */
+    class ClauseSet {
+    public:
+        ClauseSet() : m_offsets(1, 0), m_retain(true), m_nb_dropped(0) {}
+
+        // if retain is false, the clauses added from now on are counted but not stored
+        void set_retain(bool retain) { m_retain = retain; }
+        bool retains() const { return m_retain; }
+
+        void add(ClauseRef cl)
+        {
+            if (!m_retain) {
+                ++m_nb_dropped;
+                return;
+            }
+            m_lits.insert(m_lits.end(), cl.begin(), cl.end());
+            m_offsets.push_back(m_lits.size());
+        }
+
+        ClauseRef operator[](size_t i) const
+        {
+            return ClauseRef(m_lits.data() + m_offsets[i], m_lits.data() + m_offsets[i + 1]);
+        }
+
+        size_t size() const { return nb_stored() + m_nb_dropped; } // number of clauses added
+        size_t nb_stored() const { return m_offsets.size() - 1; } // number of clauses that can be accessed
+        size_t nb_lits() const { return m_lits.size(); }
+        bool empty() const { return size() == 0; }
+
+        void clear()
+        {
+            m_lits.clear();
+            m_offsets.resize(1);
+            m_nb_dropped = 0;
+        }
+
+        // iterates over the clauses as ClauseRef
+        class const_iterator {
+        public:
+            const_iterator(const ClauseSet &set, size_t i) : m_set(set), m_i(i) {}
+            ClauseRef operator*() const { return m_set[m_i]; }
+            const_iterator& operator++() { ++m_i; return *this; }
+            bool operator!=(const const_iterator &other) const { return m_i != other.m_i; }
+        private:
+            const ClauseSet &m_set;
+            size_t m_i;
+        };
+
+        const_iterator begin() const { return const_iterator(*this, 0); }
+        const_iterator end() const { return const_iterator(*this, nb_stored()); }
+
+    private:
+        std::vector<int> m_lits;
+        std::vector<size_t> m_offsets; // m_offsets[i] is the position in m_lits where the ith clause starts
+        bool m_retain;
+        size_t m_nb_dropped; // number of clauses added while not retaining
+    }; // ClauseSet definition
+
+} // namespace leximaxIST
+
+#endif
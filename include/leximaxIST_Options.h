@@ -45,6 +45,9 @@ namespace leximaxIST {
         Option<std::string> m_optimise;
         Option<std::string> m_input_file_name;
         Option<int> m_disjoint_cores;
+        Option<int> m_snet_select;
+        Option<int> m_half_comp;
+        Option<int> m_decompose;
         Option<std::string> m_approx;
         Option<double> m_timeout;
         Option<int> m_mss_tol;
@@ -55,6 +58,12 @@ namespace leximaxIST {
         Option<int> m_pb_enc;
         Option<int> m_card_enc;
         Option<std::string> m_ilp_solver;
+        Option<std::string> m_portfolio;
+        Option<int> m_threads;
+        Option<int> m_batch;
+        Option<int> m_daemon;
+        Option<std::string> m_sat_backend;
+        Option<int> m_solution_phases;
         
     public:
         Options(); // starts Options with default settings and descriptions
@@ -64,6 +73,9 @@ namespace leximaxIST {
         int get_verbosity();
         int get_leave_tmp_files();
         int get_disjoint_cores();
+        int get_snet_select();
+        int get_half_comp();
+        int get_decompose();
         const std::string& get_optimise();
         const std::string& get_approx();
         const std::string& get_input_file_name();
@@ -76,6 +88,12 @@ namespace leximaxIST {
         int get_pb_enc();
         int get_card_enc();
         const std::string& get_ilp_solver();
+        const std::string& get_portfolio();
+        int get_threads();
+        int get_batch();
+        int get_daemon();
+        const std::string& get_sat_backend();
+        int get_solution_phases();
         
     private:
         void read_integer(const char *optarg, const std::string &optname, int &i);
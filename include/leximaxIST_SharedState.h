@@ -0,0 +1,41 @@
+#ifndef LEXIMAXIST_SHAREDSTATE
+#define LEXIMAXIST_SHAREDSTATE
+#include <leximaxIST_types.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace leximaxIST {
+
+    /* state shared by the solvers that work on copies of the same problem in different threads
+     * (the portfolio of optimisation algorithms and the parallel approximation algorithms)
+     */
+    struct SharedState {
+        std::mutex mutex; // protects the members below, except stop
+        std::vector<int> solution; // leximax-best assignment found by any of the solvers (up to the input variables)
+        std::vector<int> s_obj_vec; // objective vector of solution, sorted in descending order
+        std::vector<int> lower_bounds; // proven lower bounds of the optimal maxima
+        std::vector<Clause> blocking_cls; // blocking clauses of the MSSes found by any of the solvers
+        int max_index = 0; // number of maxima of solution proven optimal (GIA)
+        int winner = -1; // index of the solver that finished first
+        std::atomic<bool> stop {false}; // when true, the SAT solvers are interrupted and the solvers give up
+    };
+
+    // bounds of the maximum minimised by the concurrent searches of a solver (see Solver::search_parallel)
+    struct SearchState {
+        SearchState(int lb, int ub, size_t nb_searches) : lb(lb), ub(ub), k(nb_searches, -1), stop(nb_searches) {}
+        std::mutex mutex; // protects the members below, except stop
+        int lb;
+        int ub;
+        std::vector<int> k; // value tested by the SAT call of each search (maximum <= k), -1 if none
+        std::vector<std::atomic<bool>> stop; // stop.at(t) interrupts the SAT call of search t
+        bool interrupted = false; // terminate was called
+        int nb_calls = 0;
+    };
+
+    // thrown by a solver when its SAT solver is interrupted because another solver has finished
+    struct Interrupted {};
+
+} // namespace leximaxIST
+
+#endif
@@ -1,20 +1,35 @@
 #ifndef LEXIMAXIST_SOLVER
 #define LEXIMAXIST_SOLVER
 #include <leximaxIST_types.h>
+#include <leximaxIST_ClauseSet.h>
 #include <IpasirWrap.h>
 #include <leximaxIST_parsing_utils.h>
 #include <leximaxIST_ILPConstraint.h>
 #include <string> // std::string
 #include <vector> // std::vector
 #include <unordered_map> // std::unordered_map
+#include <map> // std::map
 #include <utility> // std::pair
 #include <list> // std::list
+#include <random> // std::mt19937
+#include <mutex> // std::mutex
+#include <atomic> // std::atomic
+#include <iostream> // std::ostream, std::cout
 #include <sys/types.h> // pid_t
 
 
 namespace leximaxIST
 {
 
+    struct SharedState; // leximaxIST_SharedState.h
+    struct SearchState; // leximaxIST_SharedState.h
+
+    /* Thread safety: different Solver objects can be used concurrently by different threads.
+     * They share no mutable state and their temporary files have different names.
+     * A Solver object can only be used by one thread at a time, except for get_status, get_solution,
+     * get_objective_vector and print_solution, which can be called by other threads while the Solver is solving
+     * (they return the best solution found so far), and terminate, which interrupts the solving.
+     */
     class Solver {
         /* TODO: check if pointers can be removed without affecting performance
          * The problem is reallocation of vector while growing
@@ -28,28 +43,43 @@ namespace leximaxIST
     private:
 
         int m_verbosity; // 0: nothing, 1: solving phases, time + obj vector, 2: everything including encoding
+        unsigned long m_instance_id; // distinguishes the Solver objects of the process
         int m_id_count;
         int m_input_nb_vars; // number of vars of input problem - useful to return assignment of only these variables
-        std::vector<Clause> m_input_hard; // also contains the equivalence between soft clauses and obj variables
-        std::vector<Clause> m_encoding; // encoding clauses
+        ClauseSet m_input_hard; // also contains the equivalence between soft clauses and obj variables
+        ClauseSet m_encoding; // encoding clauses
         std::vector<int> m_soft_clauses; // unit clauses
         std::vector<std::vector<int>> m_objectives;
+        std::vector<VarInfo> m_var_info; // role of each variable (index) in the objectives and maxima, see VarInfo
         int m_num_objectives;
+        std::vector<bool> m_obj_presorted; // objectives whose variables are already sorted (weighted objectives)
         std::vector<std::vector<int>> m_sorted_vecs;
+        std::vector<std::vector<int>> m_snet_inputs; // inputs of each sorting network, to extend k-selection networks
         std::vector<std::vector<std::vector<int>>>  m_sorted_relax_collection;
         std::vector<std::list<int>> m_all_relax_vars; // relax_vars of each iteration
         std::string m_ext_solver_cmd; // for external call to optimisation solver
         std::string m_formalism;
         std::string m_ilp_solver; // ilp solver for the ilp-based algorithm
-        std::string m_file_name;
+        std::string m_file_name; // base name of the temporary files, unique to this Solver
         std::string m_opt_mode; // optimisation algorithm : lin-su, lin-us, bin, core-merge, ...
         std::string m_approx; // approximation algorithm : mss, gia
+        std::vector<std::string> m_portfolio; // optimisation algorithms run concurrently in the portfolio mode
+        SharedState *m_shared; // if not null, this solver is a worker of a portfolio or of a parallel approximation
+        std::atomic<bool> m_cancelled; // set by terminate, interrupts the SAT solvers and the algorithms
+        const std::atomic<bool> *m_cancel; // &m_cancelled, or the flag of the solver that created this worker
+        int m_nb_threads; // maximum number of threads used by the parallel parts of the algorithms
         bool m_disjoint_cores; // use disjoint cores strategy in the core-guided algorithm
+        bool m_snet_select; // only encode the outputs of the sorting networks below the upper bound (k-selection)
+        bool m_half_comparators; // only encode the clauses of the comparators that imply the outputs upwards
+        bool m_decompose; // optimise the variable-disjoint components of the problem separately
+        int m_buffer_vars; // if not negative, this solver only buffers hard clauses over these variables (see set_buffer)
+        std::string m_sat_backend; // how the SAT solvers are used: ipasir or cadical (native C++ API)
+        bool m_solution_phases; // the searches set the phases of the SAT solver to the solution before each call
         pid_t m_child_pid;
         double m_timeout; // timeout for signal handling in milliseconds
         bool m_leave_tmp_files;
         bool m_simplify_last; // if true the algorithm does not use the sorting networks in the last iteration
-        char m_status; // 's' for SATISFIABLE, 'u' for UNSATISFIABLE, '?' for UNKNOWN, 'o' for OPTIMUM FOUND
+        std::atomic<char> m_status; // 's' for SATISFIABLE, 'u' for UNSATISFIABLE, '?' for UNKNOWN, 'o' for OPTIMUM FOUND
         double m_approx_tout; // timeout for approximation
         bool m_gia_incr; // whether to use the same SAT solver in every Pareto-optimal solution search
         bool m_gia_pareto; // whether to continue to minimise to Pareto optimality, even though the maximum can not be improved
@@ -57,6 +87,7 @@ namespace leximaxIST
         bool m_mss_incr; // (truly incremental enumeration) - whether to use the same SAT solver in every MSS search
         int m_mss_nb_limit; // stop the enumeration when this number of MSSes is reached
         int m_mss_tolerance; // tolerance for choosing the next clause from a maximum objective
+        unsigned m_mss_seed; // if not 0, the soft clauses are tested in a random order (workers of the parallel MSS enumeration)
         bool m_maxsat_presolve; // to get lower bound (and upper bound) of optimum
         std::string m_maxsat_psol_cmd;
         // the next one is usefull if computation is stopped and you get an intermediate solution
@@ -64,9 +95,17 @@ namespace leximaxIST
         //int m_num_opts; // number of optimal values found: 0 = none; 1 = first maximum is optimal; 2 = first and second; ...
         std::string m_multiplication_string;
         std::vector<int> m_solution;
+        mutable std::mutex m_solution_mutex; // locked when m_solution is replaced and when it is read by get_solution
         std::vector<std::pair<int, int>> m_snet_info; // first = nb wires and second = nb comparators 
+        std::map<std::pair<size_t, size_t>, Schedule> m_sort_schedules; // key = (nb inputs, nb outputs)
         //std::vector<double> m_times; // time of each step of solving (only external solver times)
         IpasirWrap *m_sat_solver;
+        std::vector<IpasirWrap*> m_search_solvers; // SAT solvers of the concurrent searches, besides m_sat_solver
+        size_t m_search_synced; // number of clauses of m_encoding given to m_search_solvers
+        IpasirWrap *m_snapshot; // SAT solver with the hard clauses, copied by the non-incremental algorithms (see copy_hard_clauses)
+        std::string m_snapshot_preset; // configuration of m_snapshot (see CadicalWrap)
+        size_t m_snapshot_hard; // number of clauses of m_input_hard given to m_snapshot
+        int m_activation; // if not 0, the encoding clauses are added to m_sat_solver with -m_activation (see optimise_core_guided)
         std::vector<std::string> m_tmp_files; // container with the names of all temporary files used by the solver
         
     public:    
@@ -83,7 +122,7 @@ namespace leximaxIST
         
         char get_status() const;
         
-        void print_solution() const; // prints solution in a similar format to the MaxSAT output format
+        void print_solution(std::ostream &os = std::cout) const; // prints solution in a similar format to the MaxSAT output format
         
         //int get_num_opts() const;
         
@@ -101,6 +140,17 @@ namespace leximaxIST
         
         void add_soft_clauses(const std::vector<Clause> &soft_clauses);
         
+        void add_soft_clauses(const std::vector<Clause> &soft_clauses, const std::vector<int> &weights);
+        
+        int fresh_vars(int n); // reserves n new variables, with consecutive ids, and returns the first one
+        
+        /* Clause buffers, to encode constraints in several threads: each thread adds the clauses of its constraints
+         * to a Solver of its own where set_buffer was called, and the buffers are added to the solver with add_hard_clauses
+         */
+        void set_buffer(int nb_vars); // must be called before adding clauses
+        
+        void add_hard_clauses(const Solver &buffer);
+        
         void set_simplify_last(bool val);
         
         void set_timeout(double val); // for terminate function
@@ -144,8 +194,24 @@ namespace leximaxIST
         void set_mss_tol(int t);
         
         void set_disjoint_cores(bool v);
+        
+        void set_snet_select(bool v);
+        
+        void set_half_comparators(bool v);
+        
+        void set_retain_clauses(bool v); // must be called before adding clauses
+        
+        void set_portfolio(const std::vector<std::string> &modes);
+        
+        void set_nb_threads(int n);
+        
+        void set_decompose(bool v);
+        
+        void set_sat_backend(const std::string &backend); // must be called before adding clauses
+        
+        void set_solution_phases(bool v);
                 
-        int terminate(); // kill external solver and read approximate solution
+        int terminate(); // interrupt the algorithms (can be called from another thread), kill external solver and read approximate solution
         
         void clear(); // frees memory, and sets internal parameters to their initial value
         
@@ -157,9 +223,13 @@ namespace leximaxIST
         
         void reset_file_name();
         
-        void reset_id_count();
+        void update_id_count(ClauseRef clause);
+        
+        void set_var_info(int var, int role, int index, int pos, int slot = -1);
+        
+        int new_objective(const std::vector<Clause> &soft_clauses);
         
-        void update_id_count(const Clause &clause);
+        int relax_soft_clause(const Clause &soft_clause);
         
         // update m_solution if the model is leximax-better than the current solution
         // e.g. in the case the external solver is killed and outputs a suboptimal solution
@@ -174,11 +244,25 @@ namespace leximaxIST
         
         std::vector<int> get_objective_vector(const std::vector<int> &assignment) const;
         
+        int var_role(int var) const;
+        
         // constructors.cpp
         
-        void add_clause(const Clause &cl, std::vector<Clause> &set_of_clauses);
+        void copy_problem(const Solver &other);
+        
+        IpasirWrap* new_sat_solver(const std::string &preset = "") const;
+        
+        IpasirWrap* copy_hard_clauses(const std::string &preset);
+        
+        void set_stop_flags(IpasirWrap *solver) const;
         
-        void add_clause_enc(const Clause &cl);
+        Solver* new_worker(SharedState &shared) const;
+        
+        bool interrupted() const;
+        
+        void add_clause(ClauseRef cl, ClauseSet &set_of_clauses);
+        
+        void add_clause_enc(ClauseRef cl);
         
         void add_clause(int l);
         
@@ -192,11 +276,22 @@ namespace leximaxIST
         
         void encode_min(int var_out_min, int var_in1, int var_in2);
         
-        void insert_comparator(int el1, int el2, const std::vector<int> *objective, SNET &sorting_network);
+        void insert_comparator(int el1, int el2, int outputs, std::vector<int> &wire_vars);
+        
+        const Schedule& sort_schedule(size_t nb_inputs, size_t nb_outputs);
         
-        int odd_even_merge(std::pair<std::pair<int,int>,int> seq1, std::pair<std::pair<int,int>,int> seq2, const std::vector<int> *objective, SNET &sorting_network);
+        void merge_schedule(size_t size1, size_t size2, size_t nb_outputs, Schedule &schedule) const;
         
-        int encode_network(const std::pair<int,int> elems_to_sort, const std::vector<int> *objective, SNET &sorting_network);
+        int encode_schedule(const Schedule &schedule, std::vector<int> &wire_vars, std::vector<int> &output_vars);
+        
+        int encode_network(const std::vector<int> &inputs, size_t nb_outputs, std::vector<int> &outputs);
+        
+        int encode_merge(const std::vector<int> &sorted1, const std::vector<int> &sorted2,
+                         size_t nb_outputs, std::vector<int> &outputs);
+        
+        size_t snet_nb_outputs() const;
+        
+        void extend_sorted(int i, size_t nb_outputs);
         
         void merge_core_guided(const std::vector<std::vector<int>> &inputs_to_sort, const std::vector<std::vector<int>> &unit_core_vars);
         
@@ -206,6 +301,13 @@ namespace leximaxIST
         
         void encode_sorted(const std::vector<int> &inputs_to_sort, int i);
         
+        void weighted_totalizer(const std::vector<std::pair<int, int>> &terms, size_t begin, size_t end,
+                                std::map<int, int> &sums);
+        
+        void sort_presorted(std::vector<int> &vars) const;
+        
+        void unary_weighted_sum(const std::vector<std::pair<int, int>> &terms, std::vector<int> &unary);
+        
         size_t largest_obj() const;
         
         void order_encoding(const std::vector<int>& vars);
@@ -238,10 +340,10 @@ namespace leximaxIST
         
         void fix_all(int i);
         
-        void fix_only_some();
-        
         void optimise_non_core(int sum);
         
+        void new_activation();
+        
         void optimise_core_guided();
         
         void generate_max_vars(int i, std::vector<std::vector<int>> &max_vars_vec);
@@ -249,9 +351,18 @@ namespace leximaxIST
         void gen_assumps(const std::vector<int> &lower_bounds, const std::vector<std::vector<int>> &max_vars_vec,
                      const std::vector<std::vector<int>> &inputs_not_sorted, std::vector<int> &assumps) const;
                      
+        void add_disjoint_core(const std::vector<int> &core, std::vector<std::vector<int>> &inputs_not_sorted,
+                               std::vector<std::vector<int>> &unit_core_vars, std::vector<int> &lower_bounds,
+                               std::unordered_map<std::vector<bool>, int> &lb_map,
+                               std::vector<std::vector<int>> &inputs_to_sort);
+        
+        void objective_cores(int i, std::vector<std::vector<int>> &cores, std::vector<int> &model) const;
+        
+        void parallel_objective_cores(std::vector<std::vector<std::vector<int>>> &obj_cores);
+        
         bool disjoint_cores(std::vector<std::vector<int>> &inputs_not_sorted,
                                  std::vector<std::vector<int>> &unit_core_vars,
-                                 std::vector<int> &lower_bounds, std::unordered_map<int, int> &lb_map);
+                                 std::vector<int> &lower_bounds, std::unordered_map<std::vector<bool>, int> &lb_map);
         
         void increase_lb(std::vector<int> &lower_bounds, const std::vector<int> &core,
                               const std::vector<std::vector<int>> &max_vars_vec) const;
@@ -259,15 +370,55 @@ namespace leximaxIST
         void fix_max(int j, const std::vector<std::vector<int>> &max_vars_vec, const std::vector<int> &lower_bounds);
                                     
         bool find_vars_in_core(std::vector<std::vector<int>> &inputs_not_sorted, const std::vector<int> &core,
-                                    std::vector<std::vector<int>> &new_inputs) const;
+                                    std::vector<std::vector<int>> &new_inputs);
+                                    
+        void set_inputs_sorted(std::vector<std::vector<int>> &inputs_sorted) const;
                                     
-        void initialise_lb_map(std::unordered_map<int, int> &lb_map, int nb_objs) const;
-        
         void change_lb_map(int min_index, std::vector<int> &lower_bounds, const std::vector<int> &core,
-                      const std::vector<std::vector<int>> &max_vars_vec, std::unordered_map<int, int> &lb_map) const;
+                      const std::vector<std::vector<int>> &max_vars_vec, std::unordered_map<std::vector<bool>, int> &lb_map) const;
                       
         void add_unit_core_vars(const std::vector<std::vector<int>> &unit_core_vars, int j);
         
+        // alg_opt_portfolio.cpp
+        
+        void optimise_portfolio();
+        
+        void portfolio_worker(int id);
+        
+        void share_solution(const std::vector<int> &obj_vec) const;
+        
+        void share_lower_bound(int i, int lb) const;
+        
+        bool import_lower_bound(int i, int &lb);
+        
+        bool import_solution(int i, int &ub);
+        
+        // alg_approx_parallel.cpp
+        
+        void mss_enumerate_parallel();
+        
+        void share_blocking_clause(const Clause &cl) const;
+        
+        int import_blocking_clauses(size_t &nb_imported, std::vector<Clause> &new_cls) const;
+        
+        void gia_parallel();
+        
+        void gia_worker(unsigned seed);
+        
+        bool import_gia_progress(int &max_index);
+        
+        Solver* new_approx_worker(SharedState &shared) const;
+        
+        // alg_opt_components.cpp
+        
+        bool optimise_components();
+        
+        void find_components(std::vector<Component> &components) const;
+        
+        void group_components(std::vector<Component> &components) const;
+        
+        Solver* new_component_solver(const Component &component, const std::vector<int> &local_vars) const;
+        
         // alg_opt_ilp.cpp
         
         void optimise_ilp();
@@ -294,15 +445,25 @@ namespace leximaxIST
         
         void internal_solve(const int i, const int lb);
         
+        int core_lower_bound(const std::vector<int> &core) const;
+        
         void update_lb(int &lb);
         
+        void seed_phases(IpasirWrap *solver) const;
+        
         void search(int i, int lb, int ub);
         
-        void mss_add_falsified (IpasirWrap *solver, const std::vector<int> &model, std::vector<std::vector<int>> &mss, std::vector<std::vector<int>> &todo_vec, std::vector<int> &assumps);
+        void search_parallel(int i, int lb, int ub);
+        
+        void search_worker(int t, const std::string &direction, IpasirWrap *solver, int i, SearchState &state);
+        
+        void sync_search_solvers(const std::vector<std::string> &directions);
+        
+        void mss_add_falsified (IpasirWrap *solver, std::vector<std::vector<int>> &mss, std::vector<std::vector<int>> &todo_vec, std::vector<int> &assumps);
         
         int mss_choose_obj (const std::vector<std::vector<int>> &todo_vec, const std::vector<std::vector<int>> &mss, const int best_max) const;
         
-        int mss_linear_search(std::vector<std::vector<int>> &mss, IpasirWrap *solver, int &best_max);
+        int mss_linear_search(std::vector<std::vector<int>> &mss, IpasirWrap *solver, int &best_max, std::mt19937 *rng);
         
         void mss_enumerate();
         
@@ -357,7 +518,7 @@ namespace leximaxIST
         
         void print_sorted_vec (int i) const;
         
-        void print_sorted_true() const; // for debugging
+        void print_sorted_true(IpasirWrap *solver) const; // for debugging
         
         void print_objs_sorted(const std::vector<std::vector<int>> &inputs_not_sorted) const;
         
@@ -377,19 +538,19 @@ namespace leximaxIST
         
         void print_waitpid_error(const std::string &errno_str) const;
         
-        void print_clause(std::ostream &output, const Clause &cl, const std::string &leadingStr = "") const;
+        void print_clause(std::ostream &output, ClauseRef cl, const std::string &leadingStr = "") const;
         
 //         void print_wcnf_clauses(std::ostream &output, const std::vector<Clause*> &clauses, size_t weight) const;
         
 //         void print_atmost_lp(int i, std::ostream &output) const;
         
-        void print_lp_constraint(const Clause &cl, std::ostream &output) const;
+        void print_lp_constraint(ClauseRef cl, std::ostream &output) const;
         
 //         void print_sum_equals_lp(int i, std::ostream &output) const;
         
 //         void print_atmost_pb(int i, std::ostream &output) const;
         
-        void print_pb_constraint(const Clause &cl, std::ostream &output) const;
+        void print_pb_constraint(ClauseRef cl, std::ostream &output) const;
         
 //         void print_sum_equals_pb(int i, std::ostream &output) const;
         
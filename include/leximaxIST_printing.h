@@ -13,7 +13,9 @@ namespace leximaxIST {
     
     std::string ordinal(int i);
     
-    void print_lb_map(const std::unordered_map<int, int> &lb_map);
+    void print_objs(const std::vector<bool> &objs);
+    
+    void print_lb_map(const std::unordered_map<std::vector<bool>, int> &lb_map);
     
     void print_lower_bounds(const std::vector<int> &lower_bounds);
     
@@ -2,6 +2,7 @@
 #define LEXIMAXIST_TYPES
 #include <vector>
 #include <utility>
+#include <cstddef>
 
 namespace leximaxIST {
 
@@ -31,8 +32,29 @@ namespace leximaxIST {
     enum { _PB_SWC_ = 0, _PB_GTE_, _PB_ADDER_, _PB_IGTE_, _PB_KP_, _PB_KP_MINISATP_};
     enum { _PART_SEQUENTIAL_ = 0, _PART_SEQUENTIAL_SORTED_, _PART_BINARY_ };
     
-    // sorting network and clauses:
+    // sorting network (sequence of comparators) and clauses:
     typedef std::vector<std::pair<int, int>> SNET;
+    enum { _MIN_OUTPUT_ = 1, _MAX_OUTPUT_ = 2 }; // outputs of a comparator that are used
+    // comparators of a network on the wires 0, 1, ..., in flat form, only those that reach the output wires
+    struct Schedule {
+        std::vector<int> min_wires; // wire that gets the smallest output of each comparator
+        std::vector<int> max_wires; // wire that gets the greatest output of each comparator
+        std::vector<int> outputs; // used outputs of each comparator: _MIN_OUTPUT_, _MAX_OUTPUT_ or both
+        std::vector<int> output_wires; // wires of the outputs of the network in increasing order
+    };
     typedef std::vector<int> Clause;
+    // role of a variable in the core-guided algorithm: objective variable (unsorted, sorted or unit core) or maximum variable
+    enum { _NO_ROLE_ = 0, _OBJ_UNSORTED_, _OBJ_SORTED_, _OBJ_UNIT_CORE_, _MAX_VAR_ };
+    struct VarInfo {
+        int role;
+        int index; // index of the objective, or of the maximum for maximum variables
+        int pos; // position in the objective, or in the maximum variables
+        int slot; // position in the inputs not sorted of the objective, while the role is _OBJ_UNSORTED_
+    };
+    // part of the problem that shares no variables with the rest: positions of its input hard clauses and its objectives
+    struct Component {
+        std::vector<size_t> clauses;
+        std::vector<int> objectives;
+    };
 }
 #endif /* LEXIMAXIST_TYPES */
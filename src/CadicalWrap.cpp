@@ -0,0 +1,74 @@
+// the native backend is not compiled if leximaxIST is linked to a SAT solver that only implements IPASIR
+#ifndef IPASIR_ONLY
+#include <leximaxIST_printing.h>
+#include <CadicalWrap.h>
+#include <cadical.hpp>
+#include <cstdlib>
+
+namespace leximaxIST {
+    
+    // CaDiCaL calls terminate during the search, and stops if it returns true
+    class CadicalTerminator : public CaDiCaL::Terminator {
+    public:
+        CadicalTerminator(const IpasirWrap *wrap) : m_wrap(wrap) {}
+        bool terminate() override { return m_wrap->must_stop(); }
+    private:
+        const IpasirWrap *m_wrap;
+    };
+    
+    CadicalWrap::CadicalWrap(const std::string &preset) :
+    IpasirWrap(false),
+    _solver(new CaDiCaL::Solver()),
+    _terminator(new CadicalTerminator(this))
+    {
+        if (!preset.empty() && !_solver->configure(preset.c_str())) {
+            print_error_msg("Invalid CaDiCaL configuration: '" + preset + "'");
+            exit(EXIT_FAILURE);
+        }
+        _solver->connect_terminator(_terminator);
+    }
+    
+    CadicalWrap::~CadicalWrap()
+    {
+        _solver->disconnect_terminator();
+        delete _solver;
+        delete _terminator;
+    }
+    
+    void CadicalWrap::phase(int lit) { _solver->phase(lit); }
+    
+    void CadicalWrap::unphase(int lit) { _solver->unphase(lit); }
+    
+    void CadicalWrap::freeze(int lit) { _solver->freeze(lit); }
+    
+    void CadicalWrap::melt(int lit) { _solver->melt(lit); }
+    
+    // the limits of CaDiCaL only apply to the next call, and a negative limit is no limit
+    void CadicalWrap::set_limits(int conflicts, int decisions)
+    {
+        _solver->limit("conflicts", conflicts);
+        _solver->limit("decisions", decisions);
+    }
+    
+    void CadicalWrap::simplify() { _solver->simplify(); }
+    
+    void CadicalWrap::add_lit(int lit) { _solver->add(lit); }
+    
+    void CadicalWrap::assume(int lit) { _solver->assume(lit); }
+    
+    int CadicalWrap::sat_solve() { return _solver->solve(); }
+    
+    int CadicalWrap::val(int var) { return _solver->val(var) > 0 ? var : -var; }
+    
+    bool CadicalWrap::failed(int lit) { return _solver->failed(lit); }
+    
+    // CaDiCaL copies the irredundant clauses, the options (so the preset) and the variables eliminated by preprocessing
+    IpasirWrap* CadicalWrap::copy_solver() const
+    {
+        CadicalWrap *other (new CadicalWrap());
+        _solver->copy(*other->_solver);
+        return other;
+    }
+
+} /* namespace leximaxIST */
+#endif
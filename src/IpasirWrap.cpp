@@ -8,14 +8,6 @@
 
 namespace leximaxIST {
     
-    IpasirWrap::IpasirWrap() :
-    _nvars(0)
-    {
-        _s = ipasir_init();  
-    }
-    
-    IpasirWrap::~IpasirWrap() { ipasir_release(_s); }
-    
     // From the ipasir.h file:
     /**
     * The callback function is of the form "int terminate(void * state)"
@@ -23,20 +15,43 @@ namespace leximaxIST {
     *   - the solver calls the callback function with the parameter "state"
     *     having the value passed in the ipasir_set_terminate function (2nd parameter).
     */
-    int terminate(void *time_params)
+    int terminate(void *ipasir_wrap)
     {
-        // if cpu time is greater than timeout, return 1, otherwise return 0
-        double init_time (static_cast<IpasirWrap::TimeParams*>(time_params)->m_init_time);
-        double timeout (static_cast<IpasirWrap::TimeParams*>(time_params)->m_timeout);
-        if (read_cpu_time() - init_time > timeout)
-            return 1;
-        else
-            return 0;
+        return static_cast<IpasirWrap*>(ipasir_wrap)->must_stop() ? 1 : 0;
     }
     
-    /* Set _time_params and call ipasir_set_terminate
+    IpasirWrap::IpasirWrap() : IpasirWrap(true) {}
+    
+    IpasirWrap::IpasirWrap(bool ipasir) :
+    _nvars(0),
+    _projection(0),
+    _s(nullptr),
+    _time_params {0, 0, nullptr, nullptr}
+    {
+        if (ipasir) {
+            _s = ipasir_init();
+            ipasir_set_terminate (_s, this, terminate);
+        }
+    }
+    
+    IpasirWrap::~IpasirWrap()
+    {
+        if (_s != nullptr)
+            ipasir_release(_s);
+    }
+    
+    // if the stop or cancel flag is set or cpu time is greater than timeout, return true, otherwise return false
+    bool IpasirWrap::must_stop() const
+    {
+        if (_time_params.m_stop != nullptr && *_time_params.m_stop)
+            return true;
+        if (_time_params.m_cancel != nullptr && *_time_params.m_cancel)
+            return true;
+        return _time_params.m_timeout > 0 && read_cpu_time() - _time_params.m_init_time > _time_params.m_timeout;
+    }
+    
+    /* Set _time_params
      * if the timeout is <= 0, exit with an error
-     * return the current time
      */
     void IpasirWrap::set_timeout(double timeout, double init_time)
     {
@@ -46,7 +61,30 @@ namespace leximaxIST {
         }
         _time_params.m_timeout = timeout;
         _time_params.m_init_time = init_time;
-        ipasir_set_terminate (_s, &_time_params, terminate);
+    }
+    
+    void IpasirWrap::set_stop(const std::atomic<bool> *stop) { _time_params.m_stop = stop; }
+    
+    void IpasirWrap::set_cancel(const std::atomic<bool> *cancel) { _time_params.m_cancel = cancel; }
+    
+    // IPASIR does not offer these controls
+    void IpasirWrap::phase(int) {}
+    
+    void IpasirWrap::unphase(int) {}
+    
+    void IpasirWrap::freeze(int) {}
+    
+    void IpasirWrap::melt(int) {}
+    
+    void IpasirWrap::set_limits(int, int) {}
+    
+    void IpasirWrap::simplify() {}
+    
+    IpasirWrap* IpasirWrap::copy() const
+    {
+        IpasirWrap *other (copy_solver());
+        other->_nvars = _nvars;
+        return other;
     }
     
     void IpasirWrap::addClauses(const std::vector<Clause> &cls)
@@ -55,12 +93,25 @@ namespace leximaxIST {
             addClause(cl);
     }
     
-    void IpasirWrap::addClause(const Clause &clause)  {
+    void IpasirWrap::addClauses(const ClauseSet &cls)
+    {
+        for (ClauseRef cl : cls)
+            addClause(cl);
+    }
+    
+    void IpasirWrap::addClause(ClauseRef clause)  {
         for (int literal : clause)
             add(literal);
         f();
     }
     
+    void IpasirWrap::addClause(ClauseRef clause, int lit)  {
+        for (int literal : clause)
+            add(literal);
+        add(lit);
+        f();
+    }
+    
     void IpasirWrap::addClause(int p) {  add(p); f(); }
     
     void IpasirWrap::addClause(int p, int q) {  add(p); add(q); f(); }
@@ -76,6 +127,23 @@ namespace leximaxIST {
     // return a non-const reference to be able to steal _model's data with move semantics
     std::vector<int>& IpasirWrap::model() {return _model; }
     
+    void IpasirWrap::set_projection(int nb_vars)
+    {
+        if (nb_vars < 0) {
+            print_error_msg("IpasirWrap::set_projection's argument is negative!");
+            exit(EXIT_FAILURE);
+        }
+        // the projected variables are read after every call and used in the clauses added later, so they are frozen
+        for (int v (_projection + 1); v <= nb_vars; ++v)
+            freeze(v);
+        for (int v (nb_vars + 1); v <= _projection; ++v)
+            melt(v);
+        _projection = nb_vars;
+    }
+    
+    // the variables that the SAT solver does not know of are false
+    int IpasirWrap::value(int var) { return var <= _nvars ? val(var) : -var; }
+    
     const std::vector<int>& IpasirWrap::conflict() const { return _conflict; }
 
     int IpasirWrap::nVars() const {return _nvars;}
@@ -87,9 +155,9 @@ namespace leximaxIST {
 
     int IpasirWrap::solve(const std::vector<int>& assumps) {
         for (auto l : assumps)
-            ipasir_assume(_s, l);
+            assume(l);
 
-        const int r = ipasir_solve(_s);
+        const int r = sat_solve();
         if (r != 10 && r != 20 && r != 0) {
             print_error_msg("Something went wrong with ipasir_solve call, retv: " + r);
             exit(EXIT_FAILURE);
@@ -97,13 +165,13 @@ namespace leximaxIST {
         _model.clear();
         _conflict.clear();
         if (r == 10) {
-            _model.resize(_nvars + 1, 0);
-            for (int v = _nvars; v; v--) {
-            _model[v] = ipasir_val(_s, v);
-            }
+            const int nb_vars (_projection > 0 ? _projection : _nvars);
+            _model.resize(nb_vars + 1, 0);
+            for (int v = nb_vars; v; v--)
+                _model[v] = value(v);
         } else if (r == 20) {
             for (auto l : assumps) {
-                if (ipasir_failed(_s, l))
+                if (failed(l))
                     _conflict.push_back(-l);
             }
         }
@@ -113,11 +181,27 @@ namespace leximaxIST {
     void IpasirWrap::add(int p) {
          if (std::abs(p) > _nvars)
              _nvars = std::abs(p);
-        ipasir_add(_s, p);
+        add_lit(p);
     }
 
     void IpasirWrap::f() {
-        ipasir_add(_s, 0);
+        add_lit(0);
+    }
+    
+    void IpasirWrap::add_lit(int lit) { ipasir_add(_s, lit); }
+    
+    void IpasirWrap::assume(int lit) { ipasir_assume(_s, lit); }
+    
+    int IpasirWrap::sat_solve() { return ipasir_solve(_s); }
+    
+    int IpasirWrap::val(int var) { return ipasir_val(_s, var); }
+    
+    bool IpasirWrap::failed(int lit) { return ipasir_failed(_s, lit) != 0; }
+    
+    IpasirWrap* IpasirWrap::copy_solver() const
+    {
+        print_error_msg("A SAT solver used through IPASIR can not be copied");
+        exit(EXIT_FAILURE);
     }
 
 }
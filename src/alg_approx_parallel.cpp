@@ -0,0 +1,181 @@
+#include <leximaxIST_Solver.h>
+#include <leximaxIST_SharedState.h>
+#include <leximaxIST_printing.h>
+#include <vector>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <random>
+
+namespace leximaxIST {
+
+    bool descending_order (int i, int j);
+
+    /* MSS enumeration with m_nb_threads workers, each with its own copy of the problem and its own SAT solver.
+     * Each worker runs mss_enumerate, testing the soft clauses in a different order (worker 0 in the usual order).
+     * The blocking clauses of the MSSes found by any of the workers are given to all the workers,
+     * so that no MSS is found twice, and the leximax-best solution is shared.
+     * The enumeration is over when the first worker stops (all MSSes found, limit or timeout reached).
+     * The timeout is in CPU time of the process, which the workers spend simultaneously,
+     * so each worker gets m_nb_threads times the timeout.
+     */
+    void Solver::mss_enumerate_parallel()
+    {
+        if (m_verbosity >= 1) {
+            print_mss_enum_info();
+            std::cout << "c Parallel enumeration with " << m_nb_threads << " threads\n";
+        }
+        SharedState shared;
+        shared.solution.assign(m_solution.begin(), m_solution.begin() + m_input_nb_vars + 1);
+        shared.s_obj_vec = get_objective_vector();
+        std::sort(shared.s_obj_vec.begin(), shared.s_obj_vec.end(), descending_order);
+        std::vector<Solver*> workers;
+        for (int w (0); w < m_nb_threads; ++w) {
+            workers.push_back(new_approx_worker(shared));
+            workers.back()->m_mss_seed = w;
+        }
+        std::vector<std::thread> threads;
+        for (Solver *worker : workers)
+            threads.emplace_back(&Solver::mss_enumerate, worker);
+        for (std::thread &t : threads)
+            t.join();
+        for (Solver *worker : workers)
+            delete worker;
+        {
+            std::lock_guard<std::mutex> lock (m_solution_mutex);
+            m_solution = shared.solution;
+        }
+        if (m_verbosity >= 1) {
+            std::cout << "c Leximax-best solution found by the workers:\n";
+            print_obj_vector(get_objective_vector());
+            std::cout << "c Number of MSS subsets found: " << shared.blocking_cls.size() << '\n';
+        }
+    }
+
+    /* GIA with m_nb_threads workers, each with its own copy of the problem and its own SAT solver.
+     * Each worker encodes its sorting networks and runs gia from a different starting point (see gia_worker).
+     * The workers share the leximax-best solution and the number of its maxima that are proven optimal (max_index):
+     * a worker whose solution is leximax-worse than the shared one continues from the shared solution.
+     * The GIA is over when the first worker stops (optimum found or timeout reached).
+     * As in the MSS enumeration, each worker gets m_nb_threads times the timeout.
+     */
+    void Solver::gia_parallel()
+    {
+        SharedState shared;
+        shared.solution.assign(m_solution.begin(), m_solution.begin() + m_input_nb_vars + 1);
+        shared.s_obj_vec = get_objective_vector();
+        std::sort(shared.s_obj_vec.begin(), shared.s_obj_vec.end(), descending_order);
+        if (m_verbosity >= 1)
+            std::cout << "c Parallel GIA with " << m_nb_threads << " threads\n";
+        std::vector<Solver*> workers;
+        for (int w (0); w < m_nb_threads; ++w)
+            workers.push_back(new_approx_worker(shared));
+        std::vector<std::thread> threads;
+        for (int w (0); w < m_nb_threads; ++w)
+            threads.emplace_back(&Solver::gia_worker, workers.at(w), w);
+        for (std::thread &t : threads)
+            t.join();
+        for (Solver *worker : workers)
+            delete worker;
+        {
+            std::lock_guard<std::mutex> lock (m_solution_mutex);
+            m_solution = shared.solution;
+        }
+        if (m_verbosity >= 1) {
+            std::cout << "c Leximax-best solution found by the workers:\n";
+            print_obj_vector(get_objective_vector());
+            std::cout << "c Number of maxima proven optimal: " << shared.max_index << '\n';
+        }
+    }
+
+    /* runs in its own thread: encodes the sorting networks, upper bounds the objectives with the first maximum
+     * of the shared solution and runs gia
+     * if seed is not 0, gia starts from a solution where a random subset of the objective variables is false,
+     * if there is one, instead of the shared solution
+     */
+    void Solver::gia_worker(unsigned seed)
+    {
+        for (int j (0); j < m_num_objectives; ++j)
+            encode_sorted(m_objectives.at(j), j);
+        encode_bounds(0, 0);
+        if (seed != 0) {
+            std::mt19937 rng (seed);
+            std::vector<int> assumps;
+            for (const std::vector<int> &objective : m_objectives) {
+                for (int var : objective) {
+                    if (rng() % 2 == 0)
+                        assumps.push_back(-var);
+                }
+            }
+            if (m_sat_solver->solve(assumps) == 10) {
+                // the starting point may be leximax-worse than the shared solution, so it is not set with set_solution
+                m_solution.swap(m_sat_solver->model());
+                share_solution(get_objective_vector());
+            }
+        }
+        gia();
+    }
+
+    /* shares max_index, the number of maxima of this worker's solution that are proven optimal
+     * if the shared solution is leximax-better than this worker's solution, continue from the shared solution
+     * max_index is also valid for the shared solution, because it is leximax-better or equal,
+     * and vice versa, so this worker gets the maximum of both
+     * returns true if this worker's solution was replaced or max_index has increased
+     */
+    bool Solver::import_gia_progress(int &max_index)
+    {
+        std::vector<int> s_obj_vec (get_objective_vector());
+        std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
+        bool changed (false);
+        std::lock_guard<std::mutex> lock (m_shared->mutex);
+        if (max_index >= m_shared->max_index)
+            m_shared->max_index = max_index;
+        else {
+            max_index = m_shared->max_index;
+            changed = true;
+        }
+        if (m_shared->s_obj_vec < s_obj_vec) {
+            m_solution = m_shared->solution;
+            changed = true;
+        }
+        return changed;
+    }
+
+    // new worker of a parallel approximation algorithm, with a copy of the problem, of the solution and of the parameters
+    Solver* Solver::new_approx_worker(SharedState &shared) const
+    {
+        Solver *worker (new_worker(shared));
+        worker->m_solution = m_solution;
+        worker->m_approx_tout = m_approx_tout * m_nb_threads;
+        worker->m_gia_incr = m_gia_incr;
+        worker->m_gia_pareto = m_gia_pareto;
+        worker->m_mss_add_cls = m_mss_add_cls;
+        worker->m_mss_incr = m_mss_incr;
+        worker->m_mss_nb_limit = m_mss_nb_limit;
+        worker->m_mss_tolerance = m_mss_tolerance;
+        worker->m_snet_select = m_snet_select;
+        worker->m_half_comparators = m_half_comparators;
+        return worker;
+    }
+
+    // cl blocks an MSS found by this worker
+    void Solver::share_blocking_clause(const Clause &cl) const
+    {
+        std::lock_guard<std::mutex> lock (m_shared->mutex);
+        m_shared->blocking_cls.push_back(cl);
+    }
+
+    /* appends to new_cls the shared blocking clauses from position nb_imported onwards, and updates nb_imported
+     * returns the number of MSSes found by all the workers
+     */
+    int Solver::import_blocking_clauses(size_t &nb_imported, std::vector<Clause> &new_cls) const
+    {
+        std::lock_guard<std::mutex> lock (m_shared->mutex);
+        const std::vector<Clause> &blocking_cls (m_shared->blocking_cls);
+        new_cls.insert(new_cls.end(), blocking_cls.begin() + nb_imported, blocking_cls.end());
+        nb_imported = blocking_cls.size();
+        return nb_imported;
+    }
+
+}/* namespace leximaxIST */
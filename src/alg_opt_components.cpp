@@ -0,0 +1,249 @@
+#include <leximaxIST_Solver.h>
+#include <leximaxIST_printing.h>
+#include <vector>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <numeric> // std::iota
+#include <cstdlib> // std::abs
+
+namespace leximaxIST {
+
+    void append_component(Component &to, const Component &from)
+    {
+        to.clauses.insert(to.clauses.end(), from.clauses.begin(), from.clauses.end());
+        to.objectives.insert(to.objectives.end(), from.objectives.begin(), from.objectives.end());
+    }
+
+    /* Each objective function is the sum of its parts in the variable-disjoint components of the problem.
+     * If every objective is in a single component (the variables of an objective are put in the same component),
+     * the objective vector is the union of the objective vectors of the components, and replacing the solution
+     * of a component by a leximax-better one makes the whole solution leximax-better.
+     * So the leximax-optimal solutions of the components are combined into a leximax-optimal solution.
+     * The groups of components (see group_components) are optimised by up to m_nb_threads threads,
+     * each group by a Solver of its own, with the variables renumbered.
+     * Returns false, and does not solve the problem, if there are less than two groups with objectives.
+     */
+    bool Solver::optimise_components()
+    {
+        // terminate can not kill the external solvers of the components
+        if (m_opt_mode == "external" || m_opt_mode == "ilp" || m_simplify_last || m_maxsat_presolve)
+            return false;
+        std::vector<Component> groups;
+        find_components(groups);
+        const size_t nb_components (groups.size());
+        group_components(groups);
+        const int nb_groups_obj (std::count_if(groups.begin(), groups.end(), [](const Component &group) {
+            return !group.objectives.empty();
+        }));
+        if (nb_groups_obj < 2)
+            return false;
+        // local_vars[var] is the variable that represents var in the Solver of its group, vars[g] the variables of group g
+        std::vector<int> local_vars (m_input_nb_vars + 1, 0);
+        std::vector<std::vector<int>> vars (groups.size());
+        for (size_t g (0); g < groups.size(); ++g) {
+            for (size_t c : groups.at(g).clauses) {
+                for (int lit : m_input_hard[c]) {
+                    const int var (std::abs(lit));
+                    if (local_vars[var] == 0) {
+                        vars.at(g).push_back(var);
+                        local_vars[var] = vars.at(g).size();
+                    }
+                }
+            }
+        }
+        const int nb_workers (std::min<int>(m_nb_threads, groups.size()));
+        if (m_verbosity >= 1) {
+            std::cout << "c Decomposed into " << nb_components << " independent components, optimised as ";
+            std::cout << groups.size() << " subproblems by " << nb_workers << " threads\n";
+        }
+        std::vector<char> status (groups.size(), '?');
+        std::vector<std::vector<int>> solutions (groups.size());
+        std::atomic<size_t> next_group (0);
+        auto worker = [&]() {
+            for (size_t g (next_group++); g < groups.size(); g = next_group++) {
+                Solver *solver (new_component_solver(groups.at(g), local_vars));
+                solver->m_nb_threads = std::max(1, m_nb_threads / nb_workers);
+                if (groups.at(g).objectives.empty()) { // only hard clauses: any satisfying assignment is optimal
+                    const int rv (solver->m_sat_solver->solve());
+                    if (rv == 10) {
+                        solutions.at(g).swap(solver->m_sat_solver->model());
+                        status.at(g) = 'o';
+                    }
+                    else if (rv == 20)
+                        status.at(g) = 'u';
+                }
+                else {
+                    solver->optimise();
+                    status.at(g) = solver->get_status();
+                    solutions.at(g) = solver->get_solution();
+                }
+                delete solver;
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int w (0); w < nb_workers; ++w)
+            threads.emplace_back(worker);
+        for (std::thread &t : threads)
+            t.join();
+        // a group without solution: UNSATISFIABLE if it has none, otherwise it was interrupted by terminate
+        if (std::count(status.begin(), status.end(), 'u') != 0) {
+            m_status = 'u';
+            return true;
+        }
+        if (std::count(status.begin(), status.end(), '?') != 0) {
+            if (m_verbosity >= 1)
+                std::cout << "c Optimisation interrupted\n";
+            return true;
+        }
+        std::vector<int> solution (m_input_nb_vars + 1, 0);
+        for (int var (1); var <= m_input_nb_vars; ++var)
+            solution.at(var) = -var; // the variables that do not occur in the problem are false
+        for (size_t g (0); g < groups.size(); ++g) {
+            for (size_t k (0); k < vars.at(g).size(); ++k) {
+                const int var (vars.at(g).at(k));
+                if (solutions.at(g).at(k + 1) > 0)
+                    solution.at(var) = var;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock (m_solution_mutex);
+            m_solution.swap(solution);
+        }
+        m_status = std::count(status.begin(), status.end(), 's') != 0 ? 's' : 'o';
+        if (m_verbosity >= 1) {
+            if (m_status == 's')
+                std::cout << "c Optimisation interrupted\n";
+            std::cout << "c Combined solution of the components:\n";
+            print_obj_vector(get_objective_vector());
+        }
+        return true;
+    }
+
+    /* two variables are in the same component if they occur in the same input hard clause or in the same objective
+     * (union-find with union by size and path halving); the variables that occur nowhere are not in any component
+     */
+    void Solver::find_components(std::vector<Component> &components) const
+    {
+        std::vector<int> parent (m_input_nb_vars + 1);
+        std::iota(parent.begin(), parent.end(), 0);
+        std::vector<int> size (m_input_nb_vars + 1, 1);
+        auto find = [&parent](int var) {
+            while (parent[var] != var) {
+                parent[var] = parent[parent[var]];
+                var = parent[var];
+            }
+            return var;
+        };
+        auto unite = [&](int var1, int var2) {
+            int root1 (find(var1));
+            int root2 (find(var2));
+            if (root1 == root2)
+                return;
+            if (size[root1] < size[root2])
+                std::swap(root1, root2);
+            parent[root2] = root1;
+            size[root1] += size[root2];
+        };
+        for (ClauseRef cl : m_input_hard) {
+            for (int lit : cl)
+                unite(std::abs(cl[0]), std::abs(lit));
+        }
+        for (const std::vector<int> &objective : m_objectives) {
+            for (int var : objective)
+                unite(objective.at(0), var);
+        }
+        // the component of each root
+        std::vector<int> index (m_input_nb_vars + 1, -1);
+        components.clear();
+        auto component = [&](int var) -> Component& {
+            const int root (find(var));
+            if (index[root] == -1) {
+                index[root] = components.size();
+                components.emplace_back();
+            }
+            return components[index[root]];
+        };
+        for (size_t c (0); c < m_input_hard.nb_stored(); ++c)
+            component(std::abs(m_input_hard[c][0])).clauses.push_back(c);
+        for (int j (0); j < m_num_objectives; ++j)
+            component(m_objectives.at(j).at(0)).objectives.push_back(j);
+    }
+
+    /* merges the components into the groups that are optimised separately:
+     * a component with two or more objectives is a group, the components with a single objective are grouped in pairs
+     * (the optimisation algorithms need two objectives) and the components without objectives are grouped together
+     * the groups are sorted by decreasing number of clauses, so that the largest are solved first
+     */
+    void Solver::group_components(std::vector<Component> &components) const
+    {
+        std::vector<Component> groups;
+        Component hard_only;
+        int single (-1); // group with a single objective, waiting for a second one
+        for (const Component &component : components) {
+            if (component.objectives.empty())
+                append_component(hard_only, component);
+            else if (component.objectives.size() == 1 && single != -1) {
+                append_component(groups.at(single), component);
+                single = -1;
+            }
+            else {
+                if (component.objectives.size() == 1)
+                    single = groups.size();
+                groups.push_back(component);
+            }
+        }
+        if (single != -1 && groups.size() > 1) { // the last single objective joins another group
+            append_component(groups.at(single == 0 ? 1 : 0), groups.at(single));
+            groups.erase(groups.begin() + single);
+        }
+        if (!hard_only.clauses.empty())
+            groups.push_back(hard_only);
+        std::sort(groups.begin(), groups.end(), [](const Component &g1, const Component &g2) {
+            return g1.clauses.size() > g2.clauses.size();
+        });
+        components.swap(groups);
+    }
+
+    /* new Solver with the clauses and the objectives of component, where each variable var is local_vars[var],
+     * with the parameters of the optimisation algorithm of this solver, and that is interrupted by terminate
+     */
+    Solver* Solver::new_component_solver(const Component &component, const std::vector<int> &local_vars) const
+    {
+        Solver *solver (new Solver());
+        solver->m_cancel = m_cancel;
+        solver->set_sat_backend(m_sat_backend); // the SAT solver is interrupted by terminate
+        solver->m_solution_phases = m_solution_phases;
+        solver->m_opt_mode = m_opt_mode;
+        solver->m_portfolio = m_portfolio;
+        solver->m_disjoint_cores = m_disjoint_cores;
+        solver->m_snet_select = m_snet_select;
+        solver->m_half_comparators = m_half_comparators;
+        Clause cl;
+        for (size_t c : component.clauses) {
+            cl.clear();
+            for (int lit : m_input_hard[c])
+                cl.push_back(lit > 0 ? local_vars[lit] : -local_vars[-lit]);
+            solver->add_hard_clause(cl);
+        }
+        for (int j : component.objectives) {
+            const int i (solver->m_num_objectives++);
+            std::vector<int> objective;
+            for (int var : m_objectives.at(j))
+                objective.push_back(local_vars[var]);
+            for (size_t pos (0); pos < objective.size(); ++pos)
+                solver->set_var_info(objective.at(pos), _OBJ_UNSORTED_, i, pos, pos);
+            solver->m_objectives.push_back(objective);
+            solver->m_obj_presorted.push_back(m_obj_presorted.at(j));
+        }
+        solver->m_snet_info.resize(solver->m_num_objectives, std::pair(0,0));
+        solver->m_sorted_vecs.resize(solver->m_num_objectives);
+        solver->m_snet_inputs.resize(solver->m_num_objectives);
+        solver->m_all_relax_vars.resize(solver->m_num_objectives);
+        solver->m_sorted_relax_collection.resize(solver->m_num_objectives);
+        return solver;
+    }
+
+}/* namespace leximaxIST */
@@ -20,7 +20,7 @@ namespace leximaxIST {
         std::vector<ILPConstraint> constraints;
         // first copy the hard clauses to constraints
         assert(m_encoding.empty());
-        for (const Clause &cl : m_input_hard) {
+        for (ClauseRef cl : m_input_hard) {
             int rhs (1);
             std::string sign (">=");
             std::vector<int> vars;
@@ -0,0 +1,139 @@
+#include <leximaxIST_Solver.h>
+#include <leximaxIST_SharedState.h>
+#include <leximaxIST_rusage.h>
+#include <leximaxIST_printing.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+
+namespace leximaxIST {
+
+    bool descending_order (int i, int j);
+
+    /* Runs the optimisation algorithms in m_portfolio concurrently, each in its own thread,
+     * with its own copy of the problem and its own SAT solver (the workers).
+     * The workers share the leximax-best solution and the proven lower bounds of the maxima.
+     * The first worker that finishes has found the optimum and the other workers are interrupted.
+     */
+    void Solver::optimise_portfolio()
+    {
+        SharedState shared;
+        shared.lower_bounds.resize(m_num_objectives, 0);
+        // the solution of the first SAT call
+        shared.solution = m_solution;
+        shared.s_obj_vec = get_objective_vector();
+        std::sort(shared.s_obj_vec.begin(), shared.s_obj_vec.end(), descending_order);
+        if (m_verbosity >= 1) {
+            std::cout << "c Portfolio of " << m_portfolio.size() << " threads: ";
+            for (const std::string &mode : m_portfolio)
+                std::cout << mode << ' ';
+            std::cout << '\n';
+        }
+        std::vector<Solver*> workers;
+        for (const std::string &mode : m_portfolio) {
+            Solver *worker (new_worker(shared));
+            worker->set_opt_mode(mode);
+            worker->m_disjoint_cores = m_disjoint_cores;
+            worker->m_snet_select = m_snet_select;
+            worker->m_half_comparators = m_half_comparators;
+            workers.push_back(worker);
+        }
+        std::vector<std::thread> threads;
+        for (size_t w (0); w < workers.size(); ++w)
+            threads.emplace_back(&Solver::portfolio_worker, workers.at(w), w);
+        for (std::thread &t : threads)
+            t.join();
+        {
+            std::lock_guard<std::mutex> lock (m_solution_mutex);
+            m_solution = shared.solution;
+        }
+        for (Solver *worker : workers)
+            delete worker;
+        if (shared.winner == -1) // all the workers were interrupted by terminate
+            throw Interrupted();
+        if (m_verbosity >= 1)
+            std::cout << "c The optimum was found by " << m_portfolio.at(shared.winner) << '\n';
+    }
+
+    // runs in its own thread; if this worker finishes first (and is not interrupted), the others are stopped
+    void Solver::portfolio_worker(int id)
+    {
+        try {
+            optimise();
+        }
+        catch (const Interrupted&) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock (m_shared->mutex);
+        if (!m_shared->stop) {
+            m_shared->winner = id;
+            m_shared->stop = true;
+        }
+    }
+
+    // if m_solution (whose objective vector is obj_vec) is leximax-better than the shared solution, replace it
+    void Solver::share_solution(const std::vector<int> &obj_vec) const
+    {
+        std::vector<int> s_obj_vec (obj_vec);
+        std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
+        std::lock_guard<std::mutex> lock (m_shared->mutex);
+        if (m_shared->solution.empty() || s_obj_vec < m_shared->s_obj_vec) {
+            m_shared->solution.assign(m_solution.begin(), m_solution.begin() + m_input_nb_vars + 1);
+            m_shared->s_obj_vec.swap(s_obj_vec);
+        }
+    }
+
+    // lb is a proven lower bound of the optimal ith maximum
+    void Solver::share_lower_bound(int i, int lb) const
+    {
+        std::lock_guard<std::mutex> lock (m_shared->mutex);
+        if (lb > m_shared->lower_bounds.at(i))
+            m_shared->lower_bounds.at(i) = lb;
+    }
+
+    /* if another worker has proven a greater lower bound of the ith maximum,
+     * lb is increased and the new bound is added to the hard clauses (as in update_lb)
+     * returns true if lb has increased
+     */
+    bool Solver::import_lower_bound(int i, int &lb)
+    {
+        int shared_lb;
+        {
+            std::lock_guard<std::mutex> lock (m_shared->mutex);
+            shared_lb = m_shared->lower_bounds.at(i);
+        }
+        if (shared_lb <= lb)
+            return false;
+        lb = shared_lb;
+        const int size (m_soft_clauses.size());
+        add_clause(-m_soft_clauses.at(size - lb));
+        return true;
+    }
+
+    /* if another worker has found a solution with the same first i maxima (proven optimal)
+     * and a smaller ith maximum, it replaces m_solution, ub is decreased and the new bound
+     * is added to the hard clauses (as in search)
+     * returns true if ub has decreased
+     */
+    bool Solver::import_solution(int i, int &ub)
+    {
+        std::vector<int> s_obj_vec (get_objective_vector());
+        std::sort(s_obj_vec.begin(), s_obj_vec.end(), descending_order);
+        {
+            std::lock_guard<std::mutex> lock (m_shared->mutex);
+            const std::vector<int> &shared_vec (m_shared->s_obj_vec);
+            if (m_shared->solution.empty() || shared_vec.at(i) >= ub ||
+                !std::equal(s_obj_vec.begin(), s_obj_vec.begin() + i, shared_vec.begin()))
+                return false;
+            ub = shared_vec.at(i);
+            std::lock_guard<std::mutex> solution_lock (m_solution_mutex);
+            m_solution = m_shared->solution;
+        }
+        encode_ub_soft(ub);
+        return true;
+    }
+
+}/* namespace leximaxIST */
@@ -0,0 +1,397 @@
+#include <Daemon.h>
+#include <Tool.h>
+#include <leximaxIST_types.h>
+#include <leximaxIST_printing.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <climits>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+namespace leximaxIST {
+
+    // interval between two checks of the progress of a request, in milliseconds
+    const int progress_interval (50);
+
+    // reads from fd and appends to buffer, returns false if the connection was closed or there was an error
+    bool read_more(int fd, std::string &buffer)
+    {
+        char data[4096];
+        ssize_t n;
+        do
+            n = read(fd, data, sizeof(data));
+        while (n < 0 && errno == EINTR);
+        if (n <= 0)
+            return false;
+        buffer.append(data, n);
+        return true;
+    }
+
+    // returns false if the connection was closed or there was an error
+    bool send_all(int fd, const std::string &data)
+    {
+        size_t sent (0);
+        while (sent < data.size()) {
+            const ssize_t n (send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    /* sets line to the line of buffer that starts at pos (without the end of line), and pos to the start of the next line
+     * returns false if the line is not complete
+     */
+    bool next_line(const std::string &buffer, size_t &pos, std::string &line)
+    {
+        const size_t end (buffer.find('\n', pos));
+        if (end == std::string::npos)
+            return false;
+        line.assign(buffer, pos, end - pos);
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        pos = end + 1;
+        return true;
+    }
+
+    Daemon::Daemon(Options &options)
+    : m_options (options)
+    , m_nb_workers (std::max(1, options.get_threads()))
+    {}
+
+    void Daemon::run()
+    {
+        const std::string &path (m_options.get_input_file_name());
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            print_error_msg("Socket path '" + path + "' is too long");
+            exit(EXIT_FAILURE);
+        }
+        strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        const int server (socket(AF_UNIX, SOCK_STREAM, 0));
+        if (server < 0) {
+            print_error_msg("Can't create socket: " + std::string(strerror(errno)));
+            exit(EXIT_FAILURE);
+        }
+        unlink(path.c_str()); // the socket of a previous daemon
+        if (bind(server, (sockaddr*) &address, sizeof(address)) != 0 || listen(server, SOMAXCONN) != 0) {
+            print_error_msg("Can't listen on socket '" + path + "': " + std::string(strerror(errno)));
+            exit(EXIT_FAILURE);
+        }
+        for (int w (0); w < m_nb_workers; ++w)
+            std::thread(&Daemon::worker, this).detach();
+        if (m_options.get_verbosity() >= 1)
+            std::cout << "c Listening on " << path << " with " << m_nb_workers << " workers" << std::endl;
+        while (true) {
+            const int fd (accept(server, nullptr, nullptr));
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                print_error_msg("Can't accept connection: " + std::string(strerror(errno)));
+                exit(EXIT_FAILURE);
+            }
+            std::thread(&Daemon::serve, this, fd).detach();
+        }
+    }
+
+    /* each worker keeps its formula, parser and encoder (as in the batch mode),
+     * and solves one request at a time
+     */
+    void Daemon::worker()
+    {
+        MaxSATFormula maxsat_formula;
+        ParserPB parser_pb (&maxsat_formula);
+        Encoder enc (_INCREMENTAL_NONE_, m_options.get_card_enc(), _AMO_LADDER_, m_options.get_pb_enc());
+        while (true) {
+            Request *request;
+            {
+                std::unique_lock<std::mutex> lock (m_queue_mutex);
+                m_queue_cv.wait(lock, [this]() { return !m_queue.empty(); });
+                request = m_queue.front();
+                m_queue.pop_front();
+            }
+            solve_request(*request, maxsat_formula, parser_pb, enc);
+            // the request may be deleted by its connection thread from now on, the worker closes its end of the pipe
+            const int done_pipe (request->done_pipe[1]);
+            request->done.store(true, std::memory_order_release);
+            const char done ('d');
+            while (write(done_pipe, &done, 1) < 0 && errno == EINTR);
+            close(done_pipe);
+        }
+    }
+
+    void Daemon::solve_request(Request &request, MaxSATFormula &maxsat_formula, ParserPB &parser_pb, Encoder &enc)
+    {
+        if (request.format == "pbmo") {
+            maxsat_formula.clear();
+            int line;
+            const int error (parser_pb.parseString(&(request.payload[0]), &line));
+            if (error != 0)
+                request.error = "Parse Error " + std::to_string(error) + " in line " + std::to_string(line);
+            else
+                request.error = load_formula(maxsat_formula, enc, request.solver, 1);
+        }
+        else
+            request.error = load_clauses(request.payload, request.solver);
+        if (!request.error.empty())
+            return;
+        request.loaded = true;
+        // the workers spend the CPU time of the process simultaneously
+        solve(request.solver, m_options, request.approx, request.opt_mode, m_options.get_timeout() * m_nb_workers);
+    }
+
+    /* adds to solver the problem in payload, in the cnf format of the requests:
+     * h <lits> 0 (hard clause), o (new objective function), s <weight> <lits> 0 (soft clause of the last objective)
+     * returns an error message if the problem is not valid, and an empty string otherwise
+     * the problem is checked before anything is added to solver, because invalid input terminates the process
+     */
+    std::string Daemon::load_clauses(const std::string &payload, Solver &solver) const
+    {
+        std::vector<Clause> hard_clauses;
+        std::vector<std::vector<Clause>> objectives;
+        std::vector<std::vector<int>> weights;
+        int max_hard_var (0);
+        int max_soft_var (0);
+        std::istringstream lines (payload);
+        for (std::string line; std::getline(lines, line);) {
+            std::istringstream tokens (line);
+            std::string type;
+            if (!(tokens >> type) || type == "c")
+                continue; // empty line or comment
+            if (type == "o") {
+                objectives.emplace_back();
+                weights.emplace_back();
+                continue;
+            }
+            int weight (1);
+            if (type == "s") {
+                if (objectives.empty())
+                    return "Soft clause before the first objective function";
+                if (!(tokens >> weight) || weight <= 0)
+                    return "Invalid weight in line '" + line + "'";
+            }
+            else if (type != "h")
+                return "Invalid line '" + line + "'";
+            Clause cl;
+            bool terminated (false);
+            int lit;
+            while (tokens >> lit) {
+                if (lit == 0) {
+                    terminated = true;
+                    break;
+                }
+                if (lit == INT_MIN)
+                    return "Invalid literal in line '" + line + "'";
+                cl.push_back(lit);
+            }
+            if (!terminated || cl.empty())
+                return "Invalid clause in line '" + line + "'";
+            int &max_var (type == "h" ? max_hard_var : max_soft_var);
+            for (int l : cl)
+                max_var = std::max(max_var, std::abs(l));
+            if (type == "h")
+                hard_clauses.push_back(cl);
+            else {
+                objectives.back().push_back(cl);
+                weights.back().push_back(weight);
+            }
+        }
+        if (objectives.empty())
+            return "The problem does not have an objective function";
+        if (objectives.size() == 1)
+            return "The problem is single-objective";
+        for (const std::vector<int> &obj_weights : weights) {
+            if (obj_weights.empty())
+                return "Empty objective function";
+            long long sum (0);
+            for (int w : obj_weights)
+                sum += w;
+            if (sum > INT_MAX)
+                return "The sum of the weights of an objective function exceeds INT_MAX";
+        }
+        // the variables of all the soft clauses must be known before the solver creates fresh variables for the objectives
+        solver.fresh_vars(std::max(max_hard_var, max_soft_var));
+        for (const Clause &cl : hard_clauses)
+            solver.add_hard_clause(cl);
+        for (size_t i (0); i < objectives.size(); ++i)
+            solver.add_soft_clauses(objectives.at(i), weights.at(i));
+        return "";
+    }
+
+    /* header: <format> [optimise=<string>] [approx=<string>] [deadline=<seconds>]
+     * if the algorithms are not given, those of the command line are used
+     * returns an error message if the header is not valid, and an empty string otherwise
+     */
+    std::string Daemon::read_header(const std::string &header, Request &request) const
+    {
+        static const std::vector<std::string> opt_modes {"lin_su", "lin_us", "bin", "core_static", "core_merge",
+                                                         "core_rebuild", "core_rebuild_incr", "ilp", "portfolio"};
+        static const std::vector<std::string> approx_algs {"mss", "gia"};
+        std::istringstream tokens (header);
+        tokens >> request.format;
+        if (request.format != "pbmo" && request.format != "cnf")
+            return "Invalid format '" + request.format + "'";
+        request.approx = m_options.get_approx();
+        request.opt_mode = m_options.get_optimise();
+        request.deadline = 0;
+        bool default_algs (true);
+        for (std::string token; tokens >> token;) {
+            const size_t eq (token.find('='));
+            const std::string key (token.substr(0, eq));
+            const std::string value (eq == std::string::npos ? "" : token.substr(eq + 1));
+            if (key == "optimise" || key == "approx") {
+                if (default_algs) { // only the algorithms of the request are run
+                    request.approx.clear();
+                    request.opt_mode.clear();
+                    default_algs = false;
+                }
+                const std::vector<std::string> &valid (key == "optimise" ? opt_modes : approx_algs);
+                if (std::find(valid.begin(), valid.end(), value) == valid.end())
+                    return "Invalid " + key + " algorithm '" + value + "'";
+                (key == "optimise" ? request.opt_mode : request.approx) = value;
+            }
+            else if (key == "deadline") {
+                std::istringstream number (value);
+                if (!(number >> request.deadline) || !number.eof() || request.deadline <= 0)
+                    return "Invalid deadline '" + value + "'";
+            }
+            else
+                return "Invalid header field '" + token + "'";
+        }
+        return "";
+    }
+
+    /* runs in the thread of the connection fd: reads the request, gives it to the workers,
+     * sends the progress (o lines) until the request is solved and then the solution
+     * the request is terminated if the client sends a cancel line or closes the connection, or the deadline is reached
+     */
+    void Daemon::serve(int fd)
+    {
+        // read the request: header, payload and end line
+        std::string buffer;
+        std::string header;
+        std::string line;
+        size_t pos (0);
+        size_t payload_begin (std::string::npos);
+        size_t payload_end (std::string::npos);
+        while (payload_end == std::string::npos) {
+            const size_t line_begin (pos);
+            if (!next_line(buffer, pos, line)) {
+                if (!read_more(fd, buffer)) {
+                    close(fd);
+                    return;
+                }
+                continue;
+            }
+            if (payload_begin == std::string::npos) {
+                header = line;
+                payload_begin = pos;
+            }
+            else if (line == "end")
+                payload_end = line_begin;
+        }
+        Request *request (new Request());
+        request->start = std::chrono::steady_clock::now();
+        request->payload.assign(buffer, payload_begin, payload_end - payload_begin);
+        std::string client_input (buffer.substr(pos)); // what the client sent after the request
+        buffer.clear();
+        const std::string error (read_header(header, *request));
+        if (!error.empty() || pipe(request->done_pipe) != 0) {
+            send_all(fd, "e " + (error.empty() ? std::string(strerror(errno)) : error) + '\n');
+            close(fd);
+            delete request;
+            return;
+        }
+        Solver &solver (request->solver);
+        configure(solver, m_options, 0, 1); // the workers already use the threads
+        solver.set_retain_clauses(true); // the algorithms depend on the request
+        {
+            std::lock_guard<std::mutex> lock (m_queue_mutex);
+            m_queue.push_back(request);
+        }
+        m_queue_cv.notify_one();
+        // wait for the worker, sending the progress
+        bool client_open (true);
+        bool terminated (false);
+        std::vector<int> sent_obj_vec;
+        size_t input_pos (0);
+        while (true) {
+            if (!terminated && client_open) {
+                while (next_line(client_input, input_pos, line)) {
+                    if (line == "cancel") {
+                        solver.terminate();
+                        terminated = true;
+                    }
+                }
+            }
+            int timeout (progress_interval);
+            if (!terminated && request->deadline > 0) {
+                const std::chrono::duration<double> elapsed (std::chrono::steady_clock::now() - request->start);
+                const double left (request->deadline - elapsed.count());
+                if (left <= 0) {
+                    solver.terminate();
+                    terminated = true;
+                }
+                else
+                    timeout = std::min(timeout, (int) (left * 1000) + 1);
+            }
+            pollfd fds[2] = {{request->done_pipe[0], POLLIN, 0}, {fd, POLLIN, 0}};
+            if (poll(fds, client_open ? 2 : 1, timeout) < 0)
+                continue; // interrupted, the request can only be deleted when the worker has finished
+            // the pipe only wakes up poll, done synchronises with the writes of the worker
+            if (fds[0].revents != 0 && request->done.load(std::memory_order_acquire))
+                break;
+            if (client_open && fds[1].revents != 0 && !read_more(fd, client_input)) {
+                client_open = false; // nobody is waiting for the solution
+                if (!terminated) {
+                    solver.terminate();
+                    terminated = true;
+                }
+            }
+            if (request->loaded && client_open) {
+                std::vector<int> obj_vec (solver.get_objective_vector());
+                if (!obj_vec.empty() && obj_vec != sent_obj_vec) {
+                    std::string progress ("o");
+                    for (int value : obj_vec)
+                        progress += ' ' + std::to_string(value);
+                    client_open = send_all(fd, progress + '\n');
+                    sent_obj_vec.swap(obj_vec);
+                }
+            }
+        }
+        // the worker has finished: send the result
+        if (client_open) {
+            std::ostringstream result;
+            if (!request->error.empty())
+                result << "e " << request->error << '\n';
+            else {
+                const std::vector<int> obj_vec (solver.get_objective_vector());
+                if (!obj_vec.empty() && obj_vec != sent_obj_vec) {
+                    result << 'o';
+                    for (int value : obj_vec)
+                        result << ' ' << value;
+                    result << '\n';
+                }
+                solver.print_solution(result);
+            }
+            send_all(fd, result.str());
+        }
+        close(fd);
+        close(request->done_pipe[0]); // done_pipe[1] is closed by the worker
+        delete request;
+    }
+
+} // namespace leximaxIST
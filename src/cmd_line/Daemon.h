@@ -0,0 +1,58 @@
+#ifndef LEXIMAXIST_DAEMON
+#define LEXIMAXIST_DAEMON
+#include <leximaxIST_Solver.h>
+#include <leximaxIST_Options.h>
+#include <MaxSATFormula.h>
+#include <ParserPB.h>
+#include <Encoder.h>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+namespace leximaxIST {
+
+    /* Daemon mode of the command-line tool: receives solve requests through a Unix domain socket,
+     * one request per connection, and solves them with a pool of worker threads.
+     * The thread of each connection reads the request, streams the progress of the solver to the client
+     * and calls terminate if the client cancels the request or the deadline is reached.
+     * The protocol is described in the tutorial.
+     */
+    class Daemon {
+    public:
+        Daemon(Options &options); // the options are the defaults of the requests
+        [[noreturn]] void run(); // listens on the socket given as input file
+
+    private:
+        struct Request {
+            std::string format; // pbmo or cnf
+            std::string payload; // the lines between the header and the end line
+            std::string approx; // approximation algorithm (none if empty)
+            std::string opt_mode; // optimisation algorithm (none if empty)
+            double deadline; // in seconds of wall-clock time since the request was received, none if not positive
+            std::chrono::steady_clock::time_point start;
+            Solver solver;
+            std::atomic<bool> loaded {false}; // the problem was added to solver, so its solution can be read
+            std::string error; // set by the worker if the problem can not be solved
+            std::atomic<bool> done {false}; // the worker has finished, its writes to the request are visible after this
+            int done_pipe[2]; // the worker writes to (and closes) done_pipe[1] after setting done, to wake up the connection thread
+        };
+
+        Options &m_options;
+        int m_nb_workers;
+        std::deque<Request*> m_queue; // requests waiting for a worker
+        std::mutex m_queue_mutex;
+        std::condition_variable m_queue_cv;
+
+        void worker();
+        void solve_request(Request &request, MaxSATFormula &maxsat_formula, ParserPB &parser_pb, Encoder &enc);
+        std::string load_clauses(const std::string &payload, Solver &solver) const;
+        void serve(int fd);
+        std::string read_header(const std::string &header, Request &request) const;
+    };
+
+} // namespace leximaxIST
+
+#endif
@@ -54,6 +54,27 @@ MaxSATFormula *MaxSATFormula::copyMaxSATFormula() {
   return copymx;
 }
 
+// Resets the formula to the state of a new one, but the vectors keep their capacity.
+void MaxSATFormula::clear() {
+  soft_clauses.clear();
+  hard_clauses.clear();
+  objective_functions.clear();
+  cardinality_constraints.clear();
+  pb_constraints.clear();
+  n_objf = 0;
+  hard_weight = UINT64_MAX;
+  problem_type = _UNWEIGHTED_;
+  n_vars = 0;
+  n_soft = 0;
+  n_hard = 0;
+  n_initial_vars = 0;
+  sum_soft_weight = 0;
+  max_soft_weight = 0;
+  _nameToIndex.clear();
+  _indexToName.clear();
+  format = _FORMAT_PB_;
+}
+
 // Adds a new hard clause to the hard clause database.
 void MaxSATFormula::addHardClause(const std::vector<Lit> &lits) {
   Hard hc (lits);
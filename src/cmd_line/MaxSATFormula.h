@@ -118,6 +118,9 @@ public:
 
   MaxSATFormula *copyMaxSATFormula();
 
+  /*! Remove the formula, to load another one, keeping the allocated memory. */
+  void clear();
+
   //min, lower and upper bounds, and max value.
   uint64_t  bounds[MAXDIM][4];
   char ifname[max::name];
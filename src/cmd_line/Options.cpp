@@ -13,6 +13,9 @@ namespace leximaxIST {
     int Options::get_verbosity() {return m_verbosity.get_data();}
     int Options::get_leave_tmp_files() {return m_leave_tmp_files.get_data();}
     int Options::get_disjoint_cores() {return m_disjoint_cores.get_data();}
+    int Options::get_snet_select() {return m_snet_select.get_data();}
+    int Options::get_half_comp() {return m_half_comp.get_data();}
+    int Options::get_decompose() {return m_decompose.get_data();}
     const std::string& Options::get_optimise() {return m_optimise.get_data();}
     const std::string& Options::get_approx() {return m_approx.get_data();}
     const std::string& Options::get_input_file_name() {return m_input_file_name.get_data();}
@@ -25,6 +28,12 @@ namespace leximaxIST {
     int Options::get_pb_enc() {return m_pb_enc.get_data();}
     int Options::get_card_enc() {return m_card_enc.get_data();}
     const std::string& Options::get_ilp_solver() {return m_ilp_solver.get_data();}
+    const std::string& Options::get_portfolio() {return m_portfolio.get_data();}
+    int Options::get_threads() {return m_threads.get_data();}
+    int Options::get_batch() {return m_batch.get_data();}
+    int Options::get_daemon() {return m_daemon.get_data();}
+    const std::string& Options::get_sat_backend() {return m_sat_backend.get_data();}
+    int Options::get_solution_phases() {return m_solution_phases.get_data();}
     
     // constructor
     Options::Options()
@@ -33,6 +42,9 @@ namespace leximaxIST {
     , m_optimise ("")
     , m_input_file_name ("")
     , m_disjoint_cores (0)
+    , m_snet_select (0)
+    , m_half_comp (0)
+    , m_decompose (0)
     , m_approx ("")
     , m_timeout (86400)
     , m_mss_tol (0)
@@ -44,6 +56,12 @@ namespace leximaxIST {
     , m_card_enc (_CARD_MTOTALIZER_)
     , m_leave_tmp_files (0)
     , m_ilp_solver ("gurobi")
+    , m_portfolio ("")
+    , m_threads (1)
+    , m_batch (0)
+    , m_daemon (0)
+    , m_sat_backend ("ipasir")
+    , m_solution_phases (0)
     {
         // help
         const std::string name_tab (2, ' ');
@@ -74,16 +92,70 @@ namespace leximaxIST {
         description += values_tab + "bin - static sorting networks with binary search\n";
         description += values_tab + "core_static - static sorting networks with core-guided unsat-sat search\n";
         description += values_tab + "core_merge (default) - core-guided unsat-sat search using dynamic sorting networks that grow by sort and merge\n";
-        description += values_tab + "core_rebuild - core-guided unsat-sat search using dynamic sorting networks that grow by rebuild (not incremental)\n";
-        description += values_tab + "core_rebuild_incr - core-guided unsat-sat search using dynamic sorting networks that grow by rebuild (incremental)\n";
+        description += values_tab + "core_rebuild - core-guided unsat-sat search using dynamic sorting networks that grow by rebuild (all networks, replacing the previous ones)\n";
+        description += values_tab + "core_rebuild_incr - core-guided unsat-sat search using dynamic sorting networks that grow by rebuild (incremental, only the networks that grow)\n";
         description += values_tab + "ilp - ILP-based algorithm\n";
+        description += values_tab + "portfolio - run several of the SAT-based algorithms above concurrently, each in its own thread\n";
         m_optimise.set_description(description);
         
+        // portfolio
+        description = name_tab + "--portfolio <string>\n";
+        description += exp_tab + "comma-separated list of the algorithms run by the portfolio (one thread each)\n";
+        description += exp_tab + "default: core_merge,core_static,core_rebuild_incr,bin,lin_su,lin_us\n";
+        m_portfolio.set_description(description);
+        
+        // threads
+        description = name_tab + "--threads <int>\n";
+        description += exp_tab + "maximum number of threads used by the parallel parts of the algorithms (default: 1)\n";
+        description += exp_tab + "parallel parts: encoding of the PB constraints, disjoint cores presolving, MSS enumeration, GIA, lin_su, lin_us and bin (concurrent searches)\n";
+        description += exp_tab + "in batch mode: number of instances solved at the same time, each with one thread\n";
+        m_threads.set_description(description);
+        
+        // batch
+        description = name_tab + "--batch\n";
+        description += exp_tab + "batch mode: <input_file> is a directory (its .pbmo files are solved) or a file with one pbmo file name per line\n";
+        description += exp_tab + "one line is printed per instance: r <file> <status> <wall-clock seconds> <objective vector>\n";
+        description += exp_tab + "each instance is interrupted when its wall-clock time reaches --timeout\n";
+        m_batch.set_description(description);
+        
+        // daemon
+        description = name_tab + "--daemon\n";
+        description += exp_tab + "daemon mode: <input_file> is the path of a Unix domain socket where the solve requests are received\n";
+        description += exp_tab + "--threads requests are solved at the same time, the other options are the defaults of the requests\n";
+        m_daemon.set_description(description);
+        
+        // sat backend
+        description = name_tab + "--sat-backend <string>\n";
+        description += exp_tab + "how the SAT solver is used:\n";
+        description += values_tab + "ipasir (default) - through the IPASIR interface\n";
+        description += values_tab + "cadical - through the C++ API of CaDiCaL, with configurations for each search, frozen input variables and simplification between maxima\n";
+        m_sat_backend.set_description(description);
+        
+        // solution-guided phases
+        description = name_tab + "--solution-phases\n";
+        description += exp_tab + "before each SAT call of the searches, set the phases of the variables to the best solution found (cadical backend)\n";
+        m_solution_phases.set_description(description);
+        
         // disjoint cores strategy
         description = name_tab + "--dcs\n";
         description += exp_tab + "when optimising, use the disjoint cores strategy\n";
         m_disjoint_cores.set_description(description);
         
+        // k-selection networks
+        description = name_tab + "--snet-select\n";
+        description += exp_tab + "only encode the outputs of the sorting networks up to the upper bound of the 1st maximum (k-selection networks)\n";
+        m_snet_select.set_description(description);
+        
+        // half comparators
+        description = name_tab + "--half-comp\n";
+        description += exp_tab + "encode the comparators of the sorting networks with 3 clauses, only implying the outputs upwards\n";
+        m_half_comp.set_description(description);
+        
+        // decomposition into independent components
+        description = name_tab + "--decompose\n";
+        description += exp_tab + "when optimising, optimise separately (with --threads threads) the parts of the problem that share no variables\n";
+        m_decompose.set_description(description);
+        
         // leave_tmp_files
         description = name_tab + "--ltf\n";
         description += exp_tab + "leave temporary files (when solving using an external solver)\n";
@@ -217,10 +289,16 @@ namespace leximaxIST {
         static struct option long_options[] = {
             {"help", no_argument,    &(m_help.get_data()), 1},
             {"dcs",  no_argument,  &(m_disjoint_cores.get_data()), 1},
+            {"snet-select",  no_argument,  &(m_snet_select.get_data()), 1},
+            {"half-comp",  no_argument,  &(m_half_comp.get_data()), 1},
+            {"decompose",  no_argument,  &(m_decompose.get_data()), 1},
             {"mss-incr",  no_argument,  &(m_mss_incr.get_data()), 1},
             {"gia-incr",  no_argument,  &(m_gia_incr.get_data()), 1},
             {"gia-pareto",  no_argument,  &(m_gia_pareto.get_data()), 1},
             {"ltf",  no_argument,  &(m_leave_tmp_files.get_data()), 1},
+            {"batch",  no_argument,  &(m_batch.get_data()), 1},
+            {"daemon",  no_argument,  &(m_daemon.get_data()), 1},
+            {"solution-phases",  no_argument,  &(m_solution_phases.get_data()), 1},
             {"optimise",  required_argument,  0, 500},
             {"approx",  required_argument,  0, 501},
             {"mss-tol",  required_argument,  0, 502},
@@ -229,6 +307,9 @@ namespace leximaxIST {
             {"pb-enc",  required_argument,  0, 505},
             {"card-enc",  required_argument,  0, 506},
             {"ilp-solver",  required_argument,  0, 507},
+            {"portfolio",  required_argument,  0, 508},
+            {"threads",  required_argument,  0, 509},
+            {"sat-backend",  required_argument,  0, 510},
             {0, 0, 0, 0}
                 };
         int c;
@@ -252,6 +333,9 @@ namespace leximaxIST {
                 case 505: read_digit(optarg, "--pb-enc", m_pb_enc.get_data()); break;
                 case 506: read_digit(optarg, "--card-enc", m_card_enc.get_data()); break;
                 case 507: m_ilp_solver.get_data() = optarg; break;
+                case 508: m_portfolio.get_data() = optarg; break;
+                case 509: read_integer(optarg, "--threads", m_threads.get_data()); break;
+                case 510: m_sat_backend.get_data() = optarg; break;
                 case '?':
                     if (isprint (optopt))
                         fprintf (stderr, "Unknown option `-%c'.\n", optopt);
@@ -286,14 +370,23 @@ namespace leximaxIST {
     
     void Options::print_usage(std::ostream &os)
     {
-        os << "Usage: ./leximaxIST [<options>] -h|--help|((--approx <string>)|(--optimise <string>) <input_file>)\n";
+        os << "Usage: ./leximaxIST [<options>] -h|--help|((--approx <string>)|(--optimise <string>) [--batch|--daemon] <input_file>)\n";
         os << m_input_file_name.get_description();
         os << "Options:\n";
         os << m_help.get_description();
         os << m_verbosity.get_description();
         os << m_optimise.get_description();
         os << m_ilp_solver.get_description();
+        os << m_portfolio.get_description();
+        os << m_threads.get_description();
+        os << m_batch.get_description();
+        os << m_daemon.get_description();
+        os << m_sat_backend.get_description();
+        os << m_solution_phases.get_description();
         os << m_disjoint_cores.get_description();
+        os << m_snet_select.get_description();
+        os << m_half_comp.get_description();
+        os << m_decompose.get_description();
         os << m_leave_tmp_files.get_description();
         os << m_approx.get_description();
         os << m_timeout.get_description();
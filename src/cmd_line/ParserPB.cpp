@@ -47,7 +47,6 @@ ParserPB::~ParserPB() {}
 
 int ParserPB::parse(const char *fileName) {
 //     printf("ParserPB::parse\n");
-  _highestCoeffSum = 0;
 
   if ((_fd = open(fileName, O_RDONLY)) < 0) {
       const std::string fnamestr (fileName);
@@ -78,14 +77,10 @@ int ParserPB::parse(const char *fileName) {
     _fileStr[statbuf.st_size] = '\0';
 
   int line = 0;
-  while (peek_char() != '\0') {
-    int error = parseLine();
-
-    if (error != 0) {
-        print_error_msg("Parse Error " + std::to_string(error) + " in line " + std::to_string(++line));
-        exit(EXIT_FAILURE);
-    }
-    line++;
+  int error = parseString(_fileStr, &line);
+  if (error != 0) {
+      print_error_msg("Parse Error " + std::to_string(error) + " in line " + std::to_string(line));
+      exit(EXIT_FAILURE);
   }
 
   // Clear memory map of input file.
@@ -97,6 +92,28 @@ int ParserPB::parse(const char *fileName) {
   return 0;
 }
 
+//! Parse a null-terminated string with the contents of an input file.
+
+/*! Used for instances that are not in a file (e.g. received by the daemon).
+  \return Returns 0 if the string was correctly parsed, otherwise the parse
+  error, and line is set to the number of the line with the error.
+*/
+int ParserPB::parseString(char *str, int *line) {
+  _highestCoeffSum = 0;
+  _fileStr = str;
+  *line = 0;
+  while (peek_char() != '\0') {
+    int error = parseLine();
+
+    if (error != 0) {
+      ++*line;
+      return error;
+    }
+    ++*line;
+  }
+  return 0;
+}
+
 //-------------------------------------------------------------------------
 // PROTECTED
 //-------------------------------------------------------------------------
@@ -135,7 +152,7 @@ int ParserPB::parseCostFunction() {
 //     printf("ParserPB::parseCostFunction\n");
 
   // int objective = _PB_MIN_;
-  static char word[MAX_WORD_LENGTH];
+  char *word = _word;
   int i;
 
   // printf("c Parsing objective function...\n");
@@ -161,7 +178,7 @@ int ParserPB::parseCostFunction() {
   if (factor == 0){
       // Not a valid cost function
       print_error_msg("Invalid objective function");
-      exit(EXIT_FAILURE);
+      return 1;
   }
 
   int64_t coeff;
@@ -180,7 +197,9 @@ int ParserPB::parseCostFunction() {
   }
 
   do {
-    parseProduct(&coeff, varName, &varNameSize);
+    int error = parseProduct(&coeff, varName, &varNameSize);
+    if (error != 0)
+      return error;
     
     int VNOffset = (varName[0] == '~') ? 1 : 0; // AG - account for negated variables
     bool litSign = VNOffset; // AG - account for negated variables
@@ -227,13 +246,16 @@ int ParserPB::parseCostFunction() {
 int ParserPB::parseProduct(int64_t *coeff, char *varName, int *varNameSize) {
 
   skip_spaces();
-  parseNumber(coeff);
+  if (parseNumber(coeff) != 0)
+    return 4;
   skip_spaces();
   if (peek_char() == '*')
     get_char(); // To allow for '*' between coefficient and variable name
   skip_spaces();
 
   parseWord(varName, varNameSize);
+  if (*varNameSize == 0)
+    return 5; // no variable
   if (varName[(*varNameSize) - 1] == ';') {
     // Removes possible ; from variable name
     (*varNameSize)--;
@@ -267,7 +289,9 @@ int ParserPB::parseConstraint() {
     VNOffset = 0;
     litSign = false;
     
-    parseProduct(&coeff, varName, &varNameSize);
+    int error = parseProduct(&coeff, varName, &varNameSize);
+    if (error != 0)
+      return error;
     
     //AG (negated variables)
     if(varName[0] == '~'){
@@ -297,7 +321,7 @@ int ParserPB::parseConstraint() {
     if (c == '\0' || c == 10 || c == 13 || c == '\n') {
       // At the end of the line and no sign was found!!!
         print_error_msg("In ParserPB::parseConstraint(), end of constraint line without sign");
-        exit(EXIT_FAILURE);
+        return 2;
     }
   } while (c != '<' && c != '>' && c != '=');
 
@@ -317,7 +341,7 @@ int ParserPB::parseConstraint() {
 
   if (ctrSign != _PB_EQUAL_ && c != '=') {
       print_error_msg("Invalid constraint sign");
-      exit(EXIT_FAILURE);
+      return 3;
   } else if (ctrSign != _PB_EQUAL_)
     get_char();
 
@@ -325,7 +349,8 @@ int ParserPB::parseConstraint() {
 
   // Read constraint rhs
   // int64_t rhs;
-  parseNumber(&coeff);
+  if (parseNumber(&coeff) != 0)
+    return 4;
   p.addRHS(coeff);
   if (ctrSign == _PB_LESS_OR_EQUAL_) {
     p.changeSign();
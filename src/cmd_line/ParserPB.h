@@ -74,6 +74,7 @@ public:
   //-------------------------------------------------------------------------
 
   virtual int parse(const char *fileName);
+  virtual int parseString(char *str, int *line);
 
   /*void parsePBFormula(char *fileName, MaxSATFormula *max) {
     maxsat_formula = max;
@@ -101,13 +102,14 @@ protected:
   }
 
   inline void readUntilEndOfLine() {
-    static char c;
+    char c;
     while ((c = get_char()) != '\n' && c != '\0')
       ;
   }
 
-  inline void parseNumber(int64_t *coeff) {
-    static char word[MAX_WORD_LENGTH];
+  // returns 0 if a number was parsed, and an error code otherwise
+  inline int parseNumber(int64_t *coeff) {
+    char *word = _word;
     int i = 0, c = peek_char();
     int64_t conv;
 
@@ -125,13 +127,15 @@ protected:
     unget_char();
     word[i] = '\0';
 //     printf("char: %c\n", *(_fileStr)); 
-    assert(i > 0);
+    if (i == 0)
+      return 4; // not a number
 
     std::istringstream ss(word);
     ss >> conv;
 
     // sscanf(word, "%d", &i);
     *coeff = (*coeff) * conv;
+    return 0;
   }
 
   inline void parseWord(char *varName, int *varNameSize) {
@@ -153,6 +157,7 @@ protected:
 
   char *_fileStr;
   int _fd;
+  char _word[MAX_WORD_LENGTH]; // buffer of parseNumber and parseCostFunction (a member, so that parsers can run in parallel)
 
   std::vector<int64_t> _coefficients;
   std::vector<int> _constraintVariables;
@@ -0,0 +1,155 @@
+#include <Tool.h>
+#include <leximaxIST_types.h>
+#include <FormulaPB.h>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <climits>
+
+namespace leximaxIST {
+
+    // below this number of constraints per thread, the constraints are encoded by a single thread
+    const int min_constraints_per_thread (500);
+
+    void configure(Solver &solver, Options &options, int verbosity, int nb_threads)
+    {
+        solver.set_verbosity(verbosity);
+        solver.set_sat_backend(options.get_sat_backend());
+        solver.set_solution_phases(options.get_solution_phases());
+        solver.set_leave_tmp_files(options.get_leave_tmp_files());
+        solver.set_snet_select(options.get_snet_select());
+        solver.set_half_comparators(options.get_half_comp());
+        solver.set_decompose(options.get_decompose());
+        solver.set_nb_threads(nb_threads);
+        // the hard clauses are only kept if the algorithms read them again (to rebuild the SAT solver or write files)
+        const std::string &opt_mode (options.get_optimise());
+        const std::string &approx (options.get_approx());
+        solver.set_retain_clauses(opt_mode == "external" || opt_mode == "ilp" || opt_mode == "portfolio" ||
+                                  nb_threads > 1 || options.get_decompose() ||
+                                  (approx == "gia" && !options.get_gia_incr()) || (approx == "mss" && !options.get_mss_incr()));
+    }
+
+    std::string load_formula(MaxSATFormula &maxsat_formula, Encoder &enc, Solver &solver, int nb_threads)
+    {
+        // the solver terminates the process if the problem is not multi-objective or an objective is invalid
+        if (maxsat_formula.nObjFunctions() == 0)
+            return "The problem does not have an objective function";
+        if (maxsat_formula.nObjFunctions() == 1)
+            return "The problem is single-objective";
+        for (int i (0); i < maxsat_formula.nObjFunctions(); ++i) {
+            uint64_t sum (0);
+            for (uint64_t coeff : maxsat_formula.getObjFunction(i)._coeffs) {
+                if (coeff > INT_MAX)
+                    return "Objective function coefficient exceeds INT_MAX";
+                sum += coeff;
+            }
+            if (sum == 0)
+                return "Empty objective function";
+            if (sum > INT_MAX)
+                return "The sum of the coefficients of an objective function exceeds INT_MAX";
+        }
+
+        // the ids of the input variables are reserved first, the variables that only occur in constraints included
+        if (maxsat_formula.nVars() > 0)
+            solver.fresh_vars(maxsat_formula.nVars());
+
+        // add hard clauses
+        for (size_t pos (0); pos < maxsat_formula.nHard(); ++pos) {
+            std::vector<int> hc (maxsat_formula.getHardClause(pos).clause);
+            solver.add_hard_clause(hc);
+        }
+
+        // pb constraints
+        for (int i = 0; i < maxsat_formula.nPB(); i++) {
+            // Make sure the PB is on the form <=
+            if (!maxsat_formula.getPBConstraint(i)._sign)
+                maxsat_formula.getPBConstraint(i).changeSign();
+        }
+        // encodes the constraints first to last, pb constraints then cardinality and at most one, into S with encoder
+        auto encode = [&maxsat_formula](Encoder &encoder, Solver &S, int first, int last) {
+            for (int i (first); i < last; ++i) {
+                if (i < maxsat_formula.nPB()) {
+                    PB &pb (maxsat_formula.getPBConstraint(i));
+                    encoder.encodePB(S, pb._lits, pb._coeffs, pb._rhs);
+                    continue;
+                }
+                Card &card (maxsat_formula.getCardinalityConstraint(i - maxsat_formula.nPB()));
+                if (card._rhs == 1)
+                    encoder.encodeAMO(S, card._lits);
+                else
+                    encoder.encodeCardinality(S, card._lits, card._rhs);
+            }
+        };
+        const int nb_constraints (maxsat_formula.nPB() + maxsat_formula.nCard());
+        const int nb_workers (std::max(1, std::min(nb_threads, nb_constraints / min_constraints_per_thread)));
+        if (nb_workers == 1)
+            encode(enc, solver, 0, nb_constraints);
+        else {
+            /* each thread encodes a contiguous range of the constraints into a clause buffer of its own,
+             * with an encoder of its own; the buffers are added in order, so the clauses and the ids of the fresh
+             * variables are the same as if the constraints were encoded by this thread
+             */
+            std::vector<Solver> buffers (nb_workers);
+            std::vector<std::thread> threads;
+            for (int w (0); w < nb_workers; ++w) {
+                buffers.at(w).set_buffer(solver.nVars());
+                threads.emplace_back([&, w]() {
+                    Encoder encoder (_INCREMENTAL_NONE_, enc.getCardEncoding(), enc.getAMOEncoding(), enc.getPBEncoding());
+                    encode(encoder, buffers.at(w), w * nb_constraints / nb_workers, (w + 1) * nb_constraints / nb_workers);
+                });
+            }
+            for (std::thread &t : threads)
+                t.join();
+            for (const Solver &buffer : buffers)
+                solver.add_hard_clauses(buffer);
+        }
+
+        // add objective functions
+        for (int i (0); i < maxsat_formula.nObjFunctions(); ++i) {
+            std::vector<Clause> soft_clauses;
+            std::vector<int> weights;
+            const PBObjFunction &obj (maxsat_formula.getObjFunction(i));
+            for (size_t j (0); j < obj._lits.size(); ++j) {
+                if (obj._coeffs.at(j) == 0)
+                    continue;
+                Clause sc;
+                sc.push_back(-(obj._lits.at(j)));
+                soft_clauses.push_back(sc);
+                weights.push_back(obj._coeffs.at(j));
+            }
+            solver.add_soft_clauses(soft_clauses, weights);
+        }
+        return "";
+    }
+
+    void solve(Solver &solver, Options &options, const std::string &approx, const std::string &opt_mode, double approx_tout)
+    {
+        // approximation
+        if (!approx.empty()) {
+            solver.set_approx(approx);
+            solver.set_mss_incr(options.get_mss_incr());
+            solver.set_mss_add_cls(options.get_mss_add_cls());
+            solver.set_mss_tol(options.get_mss_tol());
+            solver.set_gia_incr(options.get_gia_incr());
+            solver.set_gia_pareto(options.get_gia_pareto());
+            solver.set_approx_tout(approx_tout);
+            solver.approximate();
+        }
+        // optimisation
+        if (!opt_mode.empty() && solver.get_status() != 'u') {
+            solver.set_disjoint_cores(options.get_disjoint_cores());
+            solver.set_ilp_solver(options.get_ilp_solver());
+            solver.set_opt_mode(opt_mode);
+            if (!options.get_portfolio().empty()) {
+                std::vector<std::string> modes;
+                std::istringstream modes_list (options.get_portfolio());
+                for (std::string mode; std::getline(modes_list, mode, ',');)
+                    modes.push_back(mode);
+                solver.set_portfolio(modes);
+            }
+            solver.optimise();
+        }
+    }
+
+} // namespace leximaxIST
@@ -0,0 +1,29 @@
+#ifndef LEXIMAXIST_TOOL
+#define LEXIMAXIST_TOOL
+#include <leximaxIST_Solver.h>
+#include <leximaxIST_Options.h>
+#include <MaxSATFormula.h>
+#include <Encoder.h>
+#include <string>
+
+namespace leximaxIST {
+
+    // functions shared by the modes of the command-line tool: single instance, batch and daemon
+
+    // sets the parameters of solver that must be set before the problem is added
+    void configure(Solver &solver, Options &options, int verbosity, int nb_threads);
+
+    /* encodes the pseudo-boolean constraints of maxsat_formula to cnf with enc and adds the problem to solver
+     * the constraints are encoded by up to nb_threads threads, each with an encoder of the same encodings as enc
+     * returns an error message if the problem can not be solved, and an empty string otherwise
+     */
+    std::string load_formula(MaxSATFormula &maxsat_formula, Encoder &enc, Solver &solver, int nb_threads);
+
+    /* runs the approximation algorithm approx and/or the optimisation algorithm opt_mode (none if empty)
+     * approx_tout is the timeout of the approximation, in CPU time of the process
+     */
+    void solve(Solver &solver, Options &options, const std::string &approx, const std::string &opt_mode, double approx_tout);
+
+} // namespace leximaxIST
+
+#endif
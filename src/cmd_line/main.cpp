@@ -2,16 +2,26 @@
 #include <leximaxIST_Solver.h>
 #include <leximaxIST_Options.h>
 #include <leximaxIST_printing.h>
-#include <FormulaPB.h>
 #include <MaxSATFormula.h>
 #include <ParserPB.h>
 #include <Encoder.h>
+#include <Tool.h>
+#include <Daemon.h>
 #include <string>
+#include <sstream>
+#include <fstream>
 #include <iostream>
 #include <cstdlib>
 #include <signal.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <algorithm> // std::sort
+#include <limits> // std::numeric_limits
 
-leximaxIST::Solver solver;
 
 void print_header()
 {
@@ -24,21 +34,160 @@ void print_header()
     std::cout << "c -------------------------------------------------------------------------\n";
 }
 
-void signal_handler(int signum) {
-  std::cout << "c Received external signal " << signum << '\n'; 
+/* the signals are blocked in all the other threads and this thread waits for them,
+ * so it can print the solution found so far while solver is running
+ * in batch and daemon modes there is no solver (null): the records of the solved instances have already been printed
+ */
+void wait_for_signal(sigset_t signals, const leximaxIST::Solver *solver) {
+  int signum;
+  if (sigwait(&signals, &signum) != 0)
+    return;
+  std::cout << "c Received external signal " << signum << '\n';
   std::cout << "c Terminating...\n";
-  solver.print_solution();
-  exit(EXIT_SUCCESS);
+  if (solver != nullptr)
+    solver->print_solution();
+  // the solver threads are still running, so the static objects must not be destroyed (as exit would)
+  std::cout << std::flush;
+  std::_Exit(EXIT_SUCCESS);
+}
+
+/* the instances of the batch mode: the files ending in .pbmo if batch_name is a directory,
+ * otherwise the files listed in batch_name, one per line
+ */
+std::vector<std::string> read_batch(const std::string &batch_name)
+{
+    std::vector<std::string> file_names;
+    if (std::filesystem::is_directory(batch_name)) {
+        for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(batch_name)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".pbmo")
+                file_names.push_back(entry.path().string());
+        }
+        std::sort(file_names.begin(), file_names.end());
+        return file_names;
+    }
+    std::ifstream batch_file (batch_name);
+    if (!batch_file) {
+        leximaxIST::print_error_msg("Can't open batch file '" + batch_name + "'");
+        exit(EXIT_FAILURE);
+    }
+    for (std::string line; std::getline(batch_file, line);) {
+        if (!line.empty())
+            file_names.push_back(line);
+    }
+    return file_names;
+}
+
+// reads the file to content, returns false if it can not be read
+bool read_file(const std::string &file_name, std::string &content)
+{
+    std::ifstream file (file_name);
+    if (!file)
+        return false;
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str();
+    return !file.bad();
+}
+
+/* batch mode: solves the instances with --threads workers, each solving one instance at a time
+ * each worker reuses its parser, formula and encoder, and prints one record per instance:
+ * r <file> <status> <wall-clock seconds> <objective vector>
+ * an instance is interrupted (with terminate) when its wall-clock time reaches --timeout
+ */
+int solve_batch(leximaxIST::Options &options)
+{
+    const std::vector<std::string> file_names (read_batch(options.get_input_file_name()));
+    const int nb_workers (std::max(1, std::min<int>(options.get_threads(), file_names.size())));
+    if (options.get_verbosity() > 0 && options.get_verbosity() <= 2) {
+        print_header();
+        std::cout << "c Batch of " << file_names.size() << " instances, solved by " << nb_workers << " threads\n";
+    }
+    std::atomic<size_t> next_file (0);
+    std::mutex output_mutex;
+    auto worker = [&]() {
+        leximaxIST::MaxSATFormula maxsat_formula;
+        leximaxIST::ParserPB parser_pb (&maxsat_formula);
+        leximaxIST::Encoder enc (leximaxIST::_INCREMENTAL_NONE_,
+                                 options.get_card_enc(),
+                                 leximaxIST::_AMO_LADDER_,
+                                 options.get_pb_enc());
+        std::string content;
+        for (size_t f (next_file++); f < file_names.size(); f = next_file++) {
+            const std::chrono::steady_clock::time_point start (std::chrono::steady_clock::now());
+            const std::chrono::steady_clock::time_point deadline (start +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.get_timeout())));
+            maxsat_formula.clear();
+            leximaxIST::Solver solver;
+            leximaxIST::configure(solver, options, 0, 1); // the workers already use the threads
+            std::string status;
+            std::string error;
+            // parse errors terminate the process in ParserPB::parse, but not in parseString
+            if (!read_file(file_names.at(f), content))
+                error = "Can't open file";
+            else {
+                int line;
+                const int parse_error (parser_pb.parseString(&content[0], &line));
+                if (parse_error != 0)
+                    error = "Parse Error " + std::to_string(parse_error) + " in line " + std::to_string(line);
+                else
+                    error = leximaxIST::load_formula(maxsat_formula, enc, solver, 1);
+            }
+            if (!error.empty()) {
+                leximaxIST::print_error_msg(file_names.at(f) + ": " + error);
+                status = "ERROR";
+            }
+            else {
+                // the deadline is watched by another thread, the timeout of the approximation (CPU time) is not used
+                bool finished (false);
+                std::mutex finished_mutex;
+                std::condition_variable finished_cv;
+                std::thread watchdog ([&]() {
+                    std::unique_lock<std::mutex> lock (finished_mutex);
+                    if (!finished_cv.wait_until(lock, deadline, [&finished]() { return finished; }))
+                        solver.terminate();
+                });
+                leximaxIST::solve(solver, options, options.get_approx(), options.get_optimise(),
+                                  std::numeric_limits<double>::max());
+                {
+                    std::lock_guard<std::mutex> lock (finished_mutex);
+                    finished = true;
+                }
+                finished_cv.notify_one();
+                watchdog.join();
+                const char s (solver.get_status());
+                status = s == 'o' ? "OPTIMUM" : s == 's' ? "SATISFIABLE" : s == 'u' ? "UNSATISFIABLE" : "UNKNOWN";
+            }
+            const std::chrono::duration<double> time (std::chrono::steady_clock::now() - start);
+            std::ostringstream record;
+            record << "r " << file_names.at(f) << ' ' << status << ' ' << time.count();
+            if (status == "OPTIMUM" || status == "SATISFIABLE") {
+                for (int value : solver.get_objective_vector())
+                    record << ' ' << value;
+            }
+            record << '\n';
+            std::lock_guard<std::mutex> lock (output_mutex);
+            std::cout << record.str() << std::flush;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int w (0); w < nb_workers; ++w)
+        threads.emplace_back(worker);
+    for (std::thread &t : threads)
+        t.join();
+    return 0;
 }
 
 int main(int argc, char *argv[])
 {
-    // signals
-    signal(SIGHUP, signal_handler);
-    signal(SIGTERM, signal_handler);
-    signal(SIGUSR1, signal_handler);
-    signal(SIGINT, signal_handler);    
-    
+    // signals - blocked before any other thread is created, so that the threads inherit the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGUSR1);
+    sigaddset(&signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
     /* parse options */
     leximaxIST::Options options;
     if (!options.parse(argc, argv)) {
@@ -51,84 +200,41 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    solver.set_verbosity(options.get_verbosity());
-    solver.set_leave_tmp_files(options.get_leave_tmp_files());
-    
+    if (options.get_batch() == 1) {
+        std::thread(wait_for_signal, signals, nullptr).detach();
+        return solve_batch(options);
+    }
+    if (options.get_daemon() == 1) {
+        std::thread(wait_for_signal, signals, nullptr).detach();
+        leximaxIST::Daemon daemon (options);
+        daemon.run();
+    }
+
+    leximaxIST::Solver solver;
+    std::thread(wait_for_signal, signals, &solver).detach();
+    leximaxIST::configure(solver, options, options.get_verbosity(), options.get_threads());
+
     if (options.get_verbosity() > 0 && options.get_verbosity() <= 2) {
         print_header();
         std::cout << "c Parsing instance file " << options.get_input_file_name() << "...\n";
     }
-    
-    // read pbmo file
+
+    // use an encoder to encode the pseudo-boolean constraints to cnf and add the clauses to solver
     leximaxIST::MaxSATFormula maxsat_formula;
     leximaxIST::ParserPB parser_pb (&maxsat_formula);
-    parser_pb.parse(options.get_input_file_name().c_str());
-    
-    // add hard clauses
-    for (size_t pos (0); pos < maxsat_formula.nHard(); ++pos) {
-        std::vector<int> hc (maxsat_formula.getHardClause(pos).clause);
-        solver.add_hard_clause(hc);
-    }
-    
-    // use an encoder to encode the pseudo-boolean constraints to cnf and add the clauses to solver
     leximaxIST::Encoder enc (leximaxIST::_INCREMENTAL_NONE_,
                              options.get_card_enc(),
                              leximaxIST::_AMO_LADDER_,
                              options.get_pb_enc());
-    // pb constraints
-    for (int i = 0; i < maxsat_formula.nPB(); i++) {
-        // Make sure the PB is on the form <=
-        if (!maxsat_formula.getPBConstraint(i)._sign)
-            maxsat_formula.getPBConstraint(i).changeSign();
-        enc.encodePB(solver, maxsat_formula.getPBConstraint(i)._lits,
-                        maxsat_formula.getPBConstraint(i)._coeffs,
-                        maxsat_formula.getPBConstraint(i)._rhs);
-    }
-    // cardinality and at most one
-    for (int i = 0; i < maxsat_formula.nCard(); i++) {
-        if (maxsat_formula.getCardinalityConstraint(i)._rhs == 1) {
-            enc.encodeAMO(solver, maxsat_formula.getCardinalityConstraint(i)._lits);
-        } else {
-            enc.encodeCardinality(solver,
-                                    maxsat_formula.getCardinalityConstraint(i)._lits,
-                                    maxsat_formula.getCardinalityConstraint(i)._rhs);
-        }
-    }
-    
-    // add objective functions
-    for (int i (0); i < maxsat_formula.nObjFunctions(); ++i) {
-        std::vector<leximaxIST::Clause> soft_clauses;
-        const leximaxIST::PBObjFunction &obj (maxsat_formula.getObjFunction(i));
-        for (size_t j (0); j < obj._lits.size(); ++j) {
-            // repeat the clause according to its weight (for now this is how we do this)
-            for (int k (1); k <= obj._coeffs.at(j); ++k) {
-                leximaxIST::Clause sc;
-                sc.push_back(-(obj._lits.at(j)));
-                soft_clauses.push_back(sc);
-            }            
-        }
-        solver.add_soft_clauses(soft_clauses);
-    }
-    
-    // approximation
-    if (!options.get_approx().empty()) {
-        solver.set_approx(options.get_approx());
-        solver.set_mss_incr(options.get_mss_incr());
-        solver.set_mss_add_cls(options.get_mss_add_cls());
-        solver.set_mss_tol(options.get_mss_tol());
-        solver.set_gia_incr(options.get_gia_incr());
-        solver.set_gia_pareto(options.get_gia_pareto());
-        solver.set_approx_tout(options.get_timeout());
-        solver.approximate();
-    }
-    // optimisation
-    if (!options.get_optimise().empty() && solver.get_status() != 'u') {
-        solver.set_disjoint_cores(options.get_disjoint_cores());
-        solver.set_ilp_solver(options.get_ilp_solver());
-        solver.set_opt_mode(options.get_optimise());
-        solver.optimise();
+    parser_pb.parse(options.get_input_file_name().c_str());
+    const std::string error (leximaxIST::load_formula(maxsat_formula, enc, solver, options.get_threads()));
+    if (!error.empty()) {
+        leximaxIST::print_error_msg(error);
+        return 1;
     }
-    
+
+    leximaxIST::solve(solver, options, options.get_approx(), options.get_optimise(), options.get_timeout());
+
     solver.print_solution();
     return 0;
 }
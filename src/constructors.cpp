@@ -1,11 +1,22 @@
 #include <leximaxIST_Solver.h>
 #include <leximaxIST_printing.h>
+#include <leximaxIST_SharedState.h>
+#include <CadicalWrap.h>
 #include <iostream>
+#include <atomic>
 
 namespace leximaxIST {
+
+    // a different number for each Solver object of the process, for unique temporary file names
+    unsigned long new_instance_id()
+    {
+        static std::atomic<unsigned long> next_id (0);
+        return next_id++;
+    }
         
     Solver::Solver() : 
         m_verbosity(0),
+        m_instance_id(new_instance_id()),
         m_id_count(0),
         m_input_nb_vars(0),
         m_num_objectives(0),
@@ -24,14 +35,130 @@ namespace leximaxIST {
         m_mss_incr(false),
         m_mss_nb_limit(0),
         m_mss_tolerance(50), // 50 percent
+        m_mss_seed(0),
         m_maxsat_presolve(false), // do not maxsat presolve
         //m_num_opts(0),
         m_multiplication_string(" "),
         m_opt_mode("core-merge"),
+        m_portfolio {"core_merge", "core_static", "core_rebuild_incr", "bin", "lin_su", "lin_us"},
+        m_shared(nullptr),
+        m_cancelled(false),
+        m_cancel(&m_cancelled),
+        m_nb_threads(1),
         m_disjoint_cores(true),
-        m_sat_solver(nullptr)
+        m_snet_select(false),
+        m_half_comparators(false),
+        m_decompose(false),
+        m_buffer_vars(-1),
+        m_sat_backend("ipasir"),
+        m_solution_phases(false),
+        m_sat_solver(nullptr),
+        m_search_synced(0),
+        m_snapshot(nullptr),
+        m_snapshot_hard(0),
+        m_activation(0)
+    {
+        m_sat_solver = new_sat_solver();
+        reset_file_name();
+    }
+    
+    /* copies the hard clauses and the objective functions of other to this solver, that must not have a problem yet
+     * the hard clauses of other must be retained
+     */
+    void Solver::copy_problem(const Solver &other)
+    {
+        m_input_hard = other.m_input_hard;
+        m_sat_solver->addClauses(m_input_hard);
+        m_id_count = other.m_id_count;
+        m_input_nb_vars = other.m_input_nb_vars;
+        m_sat_solver->set_projection(m_input_nb_vars);
+        m_objectives = other.m_objectives;
+        m_obj_presorted = other.m_obj_presorted;
+        m_var_info = other.m_var_info;
+        m_num_objectives = other.m_num_objectives;
+        m_snet_info.resize(m_num_objectives, std::pair(0,0));
+        m_sorted_vecs.resize(m_num_objectives);
+        m_snet_inputs.resize(m_num_objectives);
+        m_all_relax_vars.resize(m_num_objectives);
+        m_sorted_relax_collection.resize(m_num_objectives);
+        m_status = '?';
+    }
+    
+    /* new SAT solver, that can be interrupted by terminate and, if this solver is a worker, by the other workers
+     * its models only have the values of the input variables, once they are known (see optimise and approximate)
+     * preset is the configuration of the native backend for the search that uses the solver (see CadicalWrap)
+     */
+    IpasirWrap* Solver::new_sat_solver(const std::string &preset) const
+    {
+        IpasirWrap *solver (nullptr);
+#ifndef IPASIR_ONLY
+        if (m_sat_backend == "cadical")
+            solver = new CadicalWrap(preset);
+#endif
+        if (solver == nullptr)
+            solver = new IpasirWrap();
+        set_stop_flags(solver);
+        solver->set_projection(m_input_nb_vars);
+        return solver;
+    }
+    
+    /* new SAT solver (see new_sat_solver) with the hard clauses, for the algorithms that do not reuse their SAT solver
+     * if the backend can copy its SAT solvers (cadical), the hard clauses are only added to m_snapshot, which is simplified
+     * when it is created and is copied for each new SAT solver; otherwise the hard clauses are added to each new SAT solver
+     */
+    IpasirWrap* Solver::copy_hard_clauses(const std::string &preset)
+    {
+        if (m_sat_backend != "cadical") {
+            IpasirWrap *solver (new_sat_solver(preset));
+            solver->addClauses(m_input_hard);
+            return solver;
+        }
+        // the configuration of CaDiCaL is copied, so there is a snapshot for a single preset at a time
+        if (m_snapshot != nullptr && m_snapshot_preset != preset) {
+            delete m_snapshot;
+            m_snapshot = nullptr;
+        }
+        if (m_snapshot == nullptr) {
+            m_snapshot = new_sat_solver(preset); // the input variables are frozen, so they are not eliminated
+            m_snapshot->addClauses(m_input_hard);
+            m_snapshot->simplify();
+            m_snapshot_preset = preset;
+            m_snapshot_hard = m_input_hard.nb_stored();
+        }
+        for (; m_snapshot_hard < m_input_hard.nb_stored(); ++m_snapshot_hard)
+            m_snapshot->addClause(m_input_hard[m_snapshot_hard]);
+        IpasirWrap *solver (m_snapshot->copy());
+        set_stop_flags(solver);
+        solver->set_projection(m_input_nb_vars);
+        return solver;
+    }
+    
+    // solver is interrupted by terminate and, if this solver is a worker, by the other workers
+    void Solver::set_stop_flags(IpasirWrap *solver) const
+    {
+        solver->set_cancel(m_cancel);
+        if (m_shared != nullptr)
+            solver->set_stop(&(m_shared->stop));
+    }
+    
+    /* new worker (of a portfolio or of a parallel approximation) with a copy of the problem,
+     * that is interrupted when shared.stop is set or when this solver is terminated
+     */
+    Solver* Solver::new_worker(SharedState &shared) const
+    {
+        Solver *worker (new Solver());
+        worker->m_shared = &shared;
+        worker->m_cancel = m_cancel;
+        worker->set_sat_backend(m_sat_backend); // the SAT solver of the worker is interrupted by its stop flags
+        worker->m_solution_phases = m_solution_phases;
+        worker->copy_problem(*this);
+        return worker;
+    }
+    
+    // true if the SAT solvers were interrupted by terminate or by another worker
+    bool Solver::interrupted() const
     {
-        m_sat_solver = new IpasirWrap();
+        return *m_cancel || (m_shared != nullptr && m_shared->stop);
     }
 
 }/* namespace leximaxIST */
@@ -1,6 +1,7 @@
 #include <leximaxIST_Solver.h>
 #include <leximaxIST_printing.h>
 #include <vector>
+#include <mutex>
 
 namespace leximaxIST {
     
@@ -8,24 +9,40 @@ namespace leximaxIST {
     void Solver::clear()
     {
         m_objectives.clear();
+        m_obj_presorted.clear();
+        m_var_info.clear();
         m_sorted_vecs.clear();
+        m_snet_inputs.clear();
         // clear relaxation variables
         m_all_relax_vars.clear();
         m_sorted_relax_collection.clear();
         m_input_hard.clear();
         m_encoding.clear();
         m_soft_clauses.clear();
-        m_solution.clear();
+        {
+            std::lock_guard<std::mutex> lock (m_solution_mutex);
+            m_solution.clear();
+        }
         m_id_count = 0;
         m_input_nb_vars = 0;
         m_num_objectives = 0;
         m_child_pid = 0;
+        m_buffer_vars = -1;
         m_status = '?';
+        m_cancelled = false;
         m_snet_info.clear();
         //m_times.clear();
         // clear sat solver
         delete m_sat_solver;
         m_sat_solver = nullptr;
+        for (IpasirWrap *solver : m_search_solvers)
+            delete solver;
+        m_search_solvers.clear();
+        m_search_synced = 0;
+        delete m_snapshot;
+        m_snapshot = nullptr;
+        m_snapshot_hard = 0;
+        m_activation = 0;
     }
     
     // remove temporary files and free memory
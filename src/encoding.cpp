@@ -1,45 +1,49 @@
 #include <leximaxIST_Solver.h>
 #include <leximaxIST_rusage.h>
 #include <leximaxIST_printing.h>
+#include <leximaxIST_SharedState.h>
 #include <stdlib.h>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
 #include <utility>
 #include <algorithm>
 #include <list>
 #include <cmath>
+#include <thread>
+#include <atomic>
+#include <memory>
 
 namespace leximaxIST {
 
     bool descending_order (int i, int j);
     
+    // in core_rebuild, the SAT solver is simplified after this number of rebuilds, to remove the retired encodings
+    const int rebuilds_per_simplify (8);
+    
     void Solver::encode_sorted(const std::vector<int> &obj_vars, int i)
     {
-        if (!obj_vars.empty()) {
+        if (m_obj_presorted.at(i)) { // weighted objective, its variables are the outputs of a totalizer
+            m_snet_info.at(i).first = obj_vars.size();
+            m_sorted_vecs.at(i) = obj_vars;
+            sort_presorted(m_sorted_vecs.at(i));
+            if (m_verbosity == 2)
+                print_sorted_vec(i);
+        }
+        else if (!obj_vars.empty()) {
             const size_t nb_wires = obj_vars.size();
-            m_sorted_vecs.at(i).resize(nb_wires, 0);
-            // sorting_network is initialized to a vector of pairs (-1,-1)
-            SNET sorting_network(nb_wires, {-1,-1});
-            // elems_to_sort is represented by a pair (first element, number of elements).
-            std::pair<int,int> elems_to_sort(0, nb_wires);
+            // in k-selection mode only the outputs up to the upper bound of the 1st maximum are encoded
+            const size_t nb_outputs (snet_nb_outputs());
+            if (m_snet_select)
+                m_snet_inputs.at(i) = obj_vars;
             if (m_verbosity == 2)
                 std::cout << "c -------- Sorting Network Encoding --------\n";
             m_snet_info.at(i).first = nb_wires;
-            m_snet_info.at(i).second = encode_network(elems_to_sort, &obj_vars, sorting_network);
-            // sorted_vec variables are the outputs of sorting_network
-            if (nb_wires == 1) { // in this case the sorting network is empty
-                std::vector<int> &sorted_vec = m_sorted_vecs.at(i);
-                sorted_vec.at(0) = obj_vars.at(0);
-            }
-            else {
-                for (size_t j{0}; j < nb_wires; j++) {
-                    int output_j = sorting_network.at(j).second;
-                    std::vector<int> &sorted_vec = m_sorted_vecs.at(i);
-                    sorted_vec.at(j) = output_j;
-                }
-            }
+            // sorted_vec variables are the outputs of the sorting network
+            m_snet_info.at(i).second = encode_network(obj_vars, nb_outputs, m_sorted_vecs.at(i));
             if (m_verbosity == 2)
                 print_sorted_vec(i);
         }
@@ -48,6 +52,130 @@ namespace leximaxIST {
             order_encoding(*(m_sorted_vecs.at(i)));*/
     }
 
+    /* Generalized totalizer on the terms (variable, weight) in [begin, end)
+     * sums is set to a map from each nonzero value that the weighted sum can take to a variable that is true
+     * iff the weighted sum is at least that value; the clauses go to the input hard clauses
+     */
+    void Solver::weighted_totalizer(const std::vector<std::pair<int, int>> &terms, size_t begin, size_t end,
+                                    std::map<int, int> &sums)
+    {
+        if (end - begin == 1) {
+            sums[terms.at(begin).second] = terms.at(begin).first;
+            return;
+        }
+        const size_t middle (begin + (end - begin) / 2);
+        std::map<int, int> left;
+        std::map<int, int> right;
+        weighted_totalizer(terms, begin, middle, left);
+        weighted_totalizer(terms, middle, end, right);
+        // the value 0 is represented by the variable 0, which is always true
+        left[0] = 0;
+        right[0] = 0;
+        for (const auto &[a, var_a] : left)
+            for (const auto &[b, var_b] : right)
+                if (a + b != 0)
+                    sums[a + b] = 0;
+        for (auto &[s, var_s] : sums)
+            var_s = fresh();
+        // upwards: if left >= a and right >= b then sum >= a + b
+        for (const auto &[a, var_a] : left) {
+            for (const auto &[b, var_b] : right) {
+                if (a + b == 0)
+                    continue;
+                Clause cl {sums.at(a + b)};
+                if (var_a != 0)
+                    cl.push_back(-var_a);
+                if (var_b != 0)
+                    cl.push_back(-var_b);
+                add_hard_clause(cl);
+            }
+        }
+        // order: sum >= s implies sum >= the previous value
+        for (auto it (std::next(sums.begin())); it != sums.end(); ++it)
+            add_hard_clause(Clause {-(it->second), std::prev(it)->second});
+        // downwards: if left < the value after a and right < the value after b, then sum < the value after a + b
+        for (auto it_a (left.begin()); it_a != left.end(); ++it_a) {
+            for (auto it_b (right.begin()); it_b != right.end(); ++it_b) {
+                const auto it_s (sums.upper_bound(it_a->first + it_b->first));
+                if (it_s == sums.end())
+                    continue;
+                Clause cl {-(it_s->second)};
+                if (std::next(it_a) != left.end())
+                    cl.push_back(std::next(it_a)->second);
+                if (std::next(it_b) != right.end())
+                    cl.push_back(std::next(it_b)->second);
+                add_hard_clause(cl);
+            }
+        }
+    }
+    
+    /* number of clauses of weighted_totalizer on the weights in [begin, end), or limit if it is larger than limit
+     * sums is set to the nonzero values that the weighted sum can take, in increasing order
+     * the work is bounded by limit: the sums of a node are only computed if its clauses fit in limit
+     */
+    size_t weighted_totalizer_size(const std::vector<int> &weights, size_t begin, size_t end,
+                                   std::vector<int> &sums, size_t limit)
+    {
+        sums.clear();
+        if (end - begin == 1) {
+            sums.push_back(weights.at(begin));
+            return 0;
+        }
+        const size_t middle (begin + (end - begin) / 2);
+        std::vector<int> left;
+        std::vector<int> right;
+        size_t size (weighted_totalizer_size(weights, begin, middle, left, limit));
+        if (size < limit)
+            size += weighted_totalizer_size(weights, middle, end, right, limit);
+        // upwards and downwards clauses: at most two for each pair of values of the children, including 0
+        if (size >= limit || 2 * (left.size() + 1) * (right.size() + 1) >= limit - size)
+            return limit;
+        size += 2 * (left.size() + 1) * (right.size() + 1);
+        left.push_back(0);
+        right.push_back(0);
+        for (int a : left)
+            for (int b : right)
+                if (a + b != 0)
+                    sums.push_back(a + b);
+        std::sort(sums.begin(), sums.end());
+        sums.erase(std::unique(sums.begin(), sums.end()), sums.end());
+        size += sums.size(); // order clauses
+        return std::min(size, limit);
+    }
+    
+    /* the variables of a weighted objective are the outputs of a totalizer, in increasing order
+     * so any subset of them is sorted by ordering it according to the positions in the objective
+     */
+    void Solver::sort_presorted(std::vector<int> &vars) const
+    {
+        std::sort(vars.begin(), vars.end(), [this](int v1, int v2) {
+            return m_var_info[v1].pos < m_var_info[v2].pos;
+        });
+    }
+    
+    /* encodes the weighted sum of the terms (variable, weight) in unary, sorted in increasing order like
+     * the outputs of the sorting networks: the jth last variable of unary is true iff the sum is at least j
+     * the values that the sum can not take share the variable of the next value, through an equivalence
+     */
+    void Solver::unary_weighted_sum(const std::vector<std::pair<int, int>> &terms, std::vector<int> &unary)
+    {
+        std::map<int, int> sums;
+        weighted_totalizer(terms, 0, terms.size(), sums);
+        const int total (sums.rbegin()->first);
+        unary.clear();
+        for (int j (total); j > 0; --j) {
+            const int var_s (sums.lower_bound(j)->second);
+            if (sums.count(j) != 0)
+                unary.push_back(var_s);
+            else {
+                const int var (fresh());
+                add_hard_clause(Clause {-var, var_s});
+                add_hard_clause(Clause {var, -var_s});
+                unary.push_back(var);
+            }
+        }
+    }
+
     void Solver::all_subsets(std::list<int> set, int i, Clause &clause)
     {
         int size = clause.size();
@@ -79,12 +207,44 @@ namespace leximaxIST {
         }
     }
 
+    // number of subsets of size i of a set of size n, or limit if it is larger than limit
+    size_t nb_subsets(size_t n, size_t i, size_t limit)
+    {
+        if (i > n)
+            return 0;
+        i = std::min(i, n - i);
+        size_t nb (1);
+        for (size_t j (1); j <= i; ++j) {
+            nb = nb * (n - i + j) / j; // nb is C(n - i + j, j), always an integer
+            if (nb > limit)
+                return limit;
+        }
+        return nb;
+    }
+
     void Solver::at_most(const std::list<int> &set, int i)
     {
-        // implementation with naive encoding
-        // for every combination of i + 1 vars, one of them must be false
-        Clause clause(i + 1, -1); // fill constructor i+1 elements with value -1
-        all_subsets(set, i + 1, clause);
+        if (set.size() <= (size_t) i)
+            return; // trivially satisfied
+        /* sort the set with a k-selection network of the i + 1 greatest outputs (only the upward implications)
+         * the smallest of them is true if more than i vars are true, so it must be false
+         * the comparators of the network are reused by every relaxation with the same number of objectives
+         */
+        const Schedule &schedule (sort_schedule(set.size(), i + 1));
+        const size_t nb_net_clauses (3 * schedule.outputs.size() + 1);
+        if (nb_subsets(set.size(), i + 1, nb_net_clauses) < nb_net_clauses) {
+            // naive encoding: for every combination of i + 1 vars, one of them must be false
+            Clause clause(i + 1, -1); // fill constructor i+1 elements with value -1
+            all_subsets(set, i + 1, clause);
+            return;
+        }
+        const bool half_comparators (m_half_comparators);
+        m_half_comparators = true;
+        std::vector<int> wire_vars (set.begin(), set.end());
+        std::vector<int> outputs;
+        encode_schedule(schedule, wire_vars, outputs);
+        m_half_comparators = half_comparators;
+        add_clause(-outputs.front());
     }
 
     // create new relaxation variables and sorted vectors after the relaxation
@@ -128,7 +288,9 @@ namespace leximaxIST {
                     if (m_verbosity == 2)
                         std::cout << "c ------- not relax_var implies sorted_relax["<< k << "] equals sorted[" << k << "] ------\n";
                     // not relax_j implies sorted_relax_j_k equals sorted_j_k
-                    add_clause(first_relax_var + j, -sorted_relax.at(k), sorted_vec.at(k));
+                    // with half comparators only sorted_j_k implies sorted_relax_j_k is needed (see encode_max)
+                    if (!m_half_comparators)
+                        add_clause(first_relax_var + j, -sorted_relax.at(k), sorted_vec.at(k));
                     add_clause(first_relax_var + j, sorted_relax.at(k), -sorted_vec.at(k));
                 }
             }
@@ -397,6 +559,9 @@ namespace leximaxIST {
         // refine upper bound on all obj functions (sorted vecs)
         if (m_verbosity == 2)
             std::cout << "c ------------ Upper bound on Sorted Vecs ------------\n";
+        // the upper bound must be one of the outputs of the k-selection networks
+        for (int j (0); j < m_num_objectives; ++j)
+            extend_sorted(j, first_max + 1);
         for (const std::vector<int> &sorted_vec : m_sorted_vecs) {
             int size (sorted_vec.size());
             int pos (size - 1 - first_max); // pos might be < 0
@@ -410,26 +575,6 @@ namespace leximaxIST {
         }
     }
     
-    void Solver::fix_only_some()
-    {
-        // y variables are sorted: 0...01...1
-        // find first occurrence of 1
-        size_t j (0);
-        for (; j < m_soft_clauses.size(); ++j) {
-            int var (-m_soft_clauses.at(j));
-            if (m_solution.at(var) > 0)
-                break;
-        }
-        if (j != m_soft_clauses.size()) {
-            // y_j
-            add_clause(-m_soft_clauses.at(j));
-        }
-        if (j != 0) {
-            // neg y_j-1
-            add_clause(m_soft_clauses.at(j - 1));
-        }
-    }
-    
     void Solver::fix_all(int i)
     {
         // Use objective vector because m_solution might not have the correct values
@@ -451,7 +596,6 @@ namespace leximaxIST {
     {
         if (m_verbosity == 2)
             std::cout << "c ---------- Fix value of current maximum ----------\n";
-        // fix_only_some(); // this needs the order encoding
         fix_all(i); // this may allow the sat solver to eliminate the order encoding
     }
     
@@ -460,6 +604,8 @@ namespace leximaxIST {
         if (m_verbosity >= 2)
             std::cout << std::unitbuf; // debug - flushes the output stream after any output operation       
         m_input_nb_vars = m_id_count;
+        // the algorithms only read the values of the input variables (the objective variables included)
+        m_sat_solver->set_projection(m_input_nb_vars);
         if (m_verbosity > 0 && m_verbosity <= 2) {
             std::cout << "c Optimising using algorithm " << m_opt_mode << "...\n";
             std::cout << "c Number of input variables: " << m_input_nb_vars << '\n';
@@ -488,18 +634,46 @@ namespace leximaxIST {
             print_error_msg("The problem is single-objective");
             exit(EXIT_FAILURE);
         }
-        // check if problem is satisfiable
-        if (!call_sat_solver(m_sat_solver, {})) {
-            m_status = 'u';
+        // these algorithms read the hard clauses again, to rebuild the SAT solver or to write them to a file
+        if (!m_input_hard.retains() && (m_opt_mode == "external" || m_opt_mode == "ilp" || m_opt_mode == "portfolio" ||
+            m_simplify_last || m_maxsat_presolve)) {
+            print_error_msg("Algorithm " + m_opt_mode + " needs the hard clauses, which were not retained");
+            exit(EXIT_FAILURE);
+        }
+        if (!m_input_hard.retains() && m_decompose) {
+            print_error_msg("The decomposition into components needs the hard clauses, which were not retained");
+            exit(EXIT_FAILURE);
+        }
+        // the independent components of the problem are optimised separately
+        if (m_decompose && optimise_components()) {
+            if (m_verbosity >= 1 && m_status == 'o')
+                print_time(read_cpu_time() - initial_time, "c Optimisation CPU time: ");
+            return;
+        }
+        try {
+            // check if problem is satisfiable
+            if (!call_sat_solver(m_sat_solver, {})) {
+                m_status = 'u';
+                return;
+            }
+            m_status = 's'; // update status to SATISFIABLE
+            if (m_opt_mode.substr(0, 4) == "core")
+                optimise_core_guided();
+            else if (m_opt_mode == "ilp")
+                optimise_ilp();
+            else if (m_opt_mode == "portfolio")
+                optimise_portfolio();
+            else
+                optimise_non_core(0);
+        }
+        catch (const Interrupted&) {
+            if (m_shared != nullptr)
+                throw; // the portfolio handles the interruption of its workers
+            // terminate was called: the status remains SATISFIABLE with the best solution found, or UNKNOWN
+            if (m_verbosity >= 1)
+                std::cout << "c Optimisation interrupted\n";
             return;
         }
-        m_status = 's'; // update status to SATISFIABLE
-        if (m_opt_mode.substr(0, 4) == "core")
-            optimise_core_guided();
-        else if (m_opt_mode == "ilp")
-            optimise_ilp();
-        else
-            optimise_non_core(0);            
         if (m_verbosity >= 1) // print total solving time
             print_time(read_cpu_time() - initial_time, "c Optimisation CPU time: ");
         m_status = 'o'; // update status to OPTIMUM FOUND
@@ -538,11 +712,11 @@ namespace leximaxIST {
                 internal_solve(i, lb); // can't use with simplify_last since internal solving
                 // depends on the soft variables being sorted
             // fix value of current maximum (in the end of last iteration there is no need)
-            if (i != m_num_objectives - 1)
+            if (i != m_num_objectives - 1) {
                 fix_soft_vars(i);
+                m_sat_solver->simplify(); // the SAT solver can eliminate what the fixed maximum made redundant
+            }
         }
-        if (m_verbosity == 2)
-            print_sorted_true();
     }
     
     void print_core(const std::vector<int> &core)
@@ -608,6 +782,8 @@ namespace leximaxIST {
             if (m_verbosity == 2)
                 std::cout << '\n';
         }
+        if (m_activation != 0) // the encoding of core_rebuild
+            assumps.push_back(m_activation);
         if (m_verbosity == 2)
             std::cout << "c -----------------------------------\n";
     }
@@ -628,6 +804,7 @@ namespace leximaxIST {
         max_vars_vec.at(i).resize(max_size);
         for (int j (0); j < max_size; ++j) {
             max_vars_vec.at(i).at(j) = fresh();
+            set_var_info(max_vars_vec.at(i).at(j), _MAX_VAR_, i, j);
             if (m_verbosity == 2 && j == 0)
                 std::cout << "c " << max_vars_vec.at(i).at(j) << " ... ";
             if (m_verbosity == 2 && j == max_size - 1)
@@ -637,33 +814,29 @@ namespace leximaxIST {
     
     /* Remove the obj vars in inputs_not_sorted that are in core and put them in new_inputs
      * Return true if the core intersects the obj vars and false otherwise
+     * m_var_info gives the objective of each var and its position in inputs_not_sorted
      */
     bool Solver::find_vars_in_core(std::vector<std::vector<int>> &inputs_not_sorted, const std::vector<int> &core,
-                                    std::vector<std::vector<int>> &new_inputs) const
+                                    std::vector<std::vector<int>> &new_inputs)
     {
         for (std::vector<int> &v : new_inputs)
             v.clear();
         bool intersects (false);
         // the core is {l1, l2, ..., ln} and -li is what appears in the assumptions
         for (int l : core) {
-            // find l in inputs_not_sorted
-            bool found (false);
-            size_t i (0);
-            while (!found && i < inputs_not_sorted.size()) {
-                size_t j (0);
-                while (j < inputs_not_sorted.at(i).size() && inputs_not_sorted.at(i).at(j) != l)
-                    ++j;
-                if (j < inputs_not_sorted.at(i).size()) { // found
-                    found = true;
-                    intersects = true;
-                    // remove from inputs_not_sorted and put in new_inputs
-                    new_inputs.at(i).push_back(l);
-                    // remove by puting the last element in the position j and erasing the last entry
-                    inputs_not_sorted.at(i).at(j) = inputs_not_sorted.at(i).back();
-                    inputs_not_sorted.at(i).pop_back();
-                }
-                ++i;
-            }
+            if (var_role(l) != _OBJ_UNSORTED_)
+                continue;
+            VarInfo &info (m_var_info[l]);
+            std::vector<int> &inputs (inputs_not_sorted.at(info.index));
+            intersects = true;
+            // remove from inputs_not_sorted and put in new_inputs
+            new_inputs.at(info.index).push_back(l);
+            // remove by puting the last element in the position of l and erasing the last entry
+            inputs.at(info.slot) = inputs.back();
+            m_var_info[inputs.back()].slot = info.slot;
+            inputs.pop_back();
+            info.role = _OBJ_SORTED_;
+            info.slot = -1;
         }
         if (m_verbosity >= 1) {
             std::cout << "c The core intersects the following objectives: ";
@@ -685,147 +858,102 @@ namespace leximaxIST {
         std::cout << '\n';
     }
     
-    /* generates all subsets of size n of the main set, stored in set_of_combs
-     */
-    template <typename T>
-    void combinations(std::vector<std::vector<T>> &set_of_combs, std::vector<T> main_set, std::vector<T> comb, int n)
-    {
-        if (n == 1) {
-            for (const T &e : main_set) {
-                comb.push_back(e);
-                set_of_combs.push_back(comb);
-                comb.pop_back();
-            }
-        }
-        else if (main_set.size() == n) {
-            for (const T &e : main_set)
-                comb.push_back(e);
-            set_of_combs.push_back(comb);
-        }
-        else {
-            T first_el = main_set.at(0);
-            // remove first_el from main_set
-            main_set.erase(main_set.begin());
-            combinations(set_of_combs, main_set, comb, n); // combinations that don't include first_el
-            comb.push_back(first_el);
-            combinations(set_of_combs, main_set, comb, n - 1); // combinations that include first_el
-        }
-    }
-    
     /* check if no variables of max_vars_vec appear in the core
      * in this case, we can increase some lower bound of lb_map, depending on which obj funcs it intersects
      * and this may allow an increase in the lower bound of the ith maximum
      * min_index : the maximum we are minimising
      */
     void Solver::change_lb_map(int min_index, std::vector<int> &lower_bounds, const std::vector<int> &core,
-                      const std::vector<std::vector<int>> &max_vars_vec, std::unordered_map<int, int> &lb_map) const
+                      const std::vector<std::vector<int>> &max_vars_vec, std::unordered_map<std::vector<bool>, int> &lb_map) const
     {
         std::vector<bool> intersect (m_num_objectives, false); // does the core intersect each obj
         for (int lit : core) {
+            const int var (std::abs(lit));
+            const int role (var_role(var));
+            if (role == _NO_ROLE_)
+                continue;
+            const VarInfo &info (m_var_info[var]);
             // check if it is in max_vars_vec
-            for (const std::vector<int> &max_vars : max_vars_vec) {
-                for (int m : max_vars) {
-                    if (m == std::abs(lit))
-                        return; // if a max variable appears in the core we cannot increase the lower bounds
-                }
+            if (role == _MAX_VAR_ && info.index < (int) max_vars_vec.size()) {
+                const std::vector<int> &max_vars (max_vars_vec.at(info.index));
+                if (info.pos < (int) max_vars.size() && max_vars.at(info.pos) == var)
+                    return; // if a max variable appears in the core we cannot increase the lower bounds
             }
             // check which obj c belongs to
-            bool found (false);
-            int i (-1);
-            while (!found) {
-                ++i;
-                const std::vector<int> &obj (m_objectives.at(i));
-                for (int v : obj) {
-                    if (v == lit) {
-                        found = true;
-                        break;
-                    }
-                }
-            }
-            intersect.at(i) = true;
+            if (lit > 0 && (role == _OBJ_UNSORTED_ || role == _OBJ_SORTED_ || role == _OBJ_UNIT_CORE_))
+                intersect.at(info.index) = true;
         }
         // update lb_map
-        int key (0);
-        for (int j (0); j < m_num_objectives; ++j) {
-            if (intersect.at(j))
-                key = key * 10 + j + 1;
-        }
-        ++lb_map.at(key);
+        ++lb_map[intersect];
         if (m_verbosity == 2)
             print_lb_map(lb_map);
         // update lower_bounds if possible
+        // only the sets of objs intersected by some core are in lb_map, the others have lower bound 0
         // Right now I only use all combinations for the 1st and 2nd maxima
         // For the remaining maxima I only use the individual bounds and the bound for the sum of all objs
-        // individual bounds
         std::vector<int> indiv_lbs (m_num_objectives, 0);
-        for (int j (1); j <= m_num_objectives; ++j)
-            indiv_lbs.at(j - 1) = lb_map.at(j);
+        int sum (0); // lower bound of the sum of all objs
+        for (const std::pair<const std::vector<bool>, int> &p : lb_map) {
+            const int nb_objs (std::count(p.first.begin(), p.first.end(), true));
+            if (nb_objs == 1) // individual bounds
+                indiv_lbs.at(std::find(p.first.begin(), p.first.end(), true) - p.first.begin()) = p.second;
+            if (nb_objs == m_num_objectives)
+                sum = p.second;
+        }
         std::sort (indiv_lbs.begin(), indiv_lbs.end(), descending_order);
         for (int j (0); j < m_num_objectives; ++j) {
             if (lower_bounds.at(j) < indiv_lbs.at(j))
                 lower_bounds.at(j) = indiv_lbs.at(j);
         }
         if (m_verbosity == 2) {
-            std::cout << "c LB given by keys ";
-            for (int j (1); j <= m_num_objectives; ++j)
-                std::cout << j << ' ';
-            std::cout << ": ";
+            std::cout << "c LB given by the individual objs: ";
             std::cout << indiv_lbs.at(0);
             for (int j (1); j < m_num_objectives; ++j)
                 std::cout << ", " << indiv_lbs.at(j);
             std::cout << '\n';
         }
         // sum of all objs bound
-        key = 0;
-        for (int j (1); j <= m_num_objectives; ++j)
-            key = key * 10 + j;
-        int sum (lb_map.at(key)); // key = 123...m_num_objectives
         for (int j (0); j < min_index; ++j)
             sum -= lower_bounds.at(j);
         int k (sum / (m_num_objectives - min_index));
         if (sum % m_num_objectives != 0) // ceiling
             ++k;
         if (m_verbosity == 2)
-            std::cout << "c LB given by key " << key << " : " << k << '\n';
+            std::cout << "c LB given by the sum of all objs : " << k << '\n';
         if (lower_bounds.at(min_index) < k)
             lower_bounds.at(min_index) = k;
         if (min_index == 0 || min_index == 1) {
             // remaining combinations
-            std::vector<int> objs;
-            for (int j (1); j <= m_num_objectives; ++j)
-                objs.push_back(j);
-            for (int j (2); j < m_num_objectives; ++j) {
-                std::vector<std::vector<int>> set_of_combs;
-                std::vector<int> c;
-                combinations(set_of_combs, objs, c, j);
-                for (const std::vector<int> &comb : set_of_combs) {
-                    key = 0;
-                    for (int p (0); p < comb.size(); ++p)
-                        key = key * 10 + comb.at(p);
-                    sum = lb_map.at(key);
-                    if (min_index == 0) {
-                        k = sum / comb.size();
-                        if (sum % comb.size() != 0) // ceiling
-                            ++k;
-                    }
-                    else {
-                        int k_out (sum / comb.size()); // the 1st max is not one of the objs in comb
-                        if (sum % comb.size() != 0) // ceiling
-                            ++k_out;
-                        int k_in (sum); // the 1st max is one of the objs in comb
-                        k_in -= lower_bounds.at(0);
-                        if (k_in > 0) {
-                            k_in = k_in / (comb.size() - 1);
-                            if (k_in % (comb.size() - 1) != 0) // ceiling
-                                ++k_in;
-                        }
-                        k = std::min(k_in, k_out);
+            for (const std::pair<const std::vector<bool>, int> &p : lb_map) {
+                const int comb_size (std::count(p.first.begin(), p.first.end(), true));
+                if (comb_size < 2 || comb_size == m_num_objectives)
+                    continue;
+                sum = p.second;
+                if (min_index == 0) {
+                    k = sum / comb_size;
+                    if (sum % comb_size != 0) // ceiling
+                        ++k;
+                }
+                else {
+                    int k_out (sum / comb_size); // the 1st max is not one of the objs in comb
+                    if (sum % comb_size != 0) // ceiling
+                        ++k_out;
+                    int k_in (sum); // the 1st max is one of the objs in comb
+                    k_in -= lower_bounds.at(0);
+                    if (k_in > 0) {
+                        k_in = k_in / (comb_size - 1);
+                        if (k_in % (comb_size - 1) != 0) // ceiling
+                            ++k_in;
                     }
-                    if (m_verbosity == 2)
-                        std::cout << "c LB given by key " << key << " : " << k << '\n';
-                    if (lower_bounds.at(min_index) < k)
-                        lower_bounds.at(min_index) = k;
+                    k = std::min(k_in, k_out);
                 }
+                if (m_verbosity == 2) {
+                    std::cout << "c LB given by the sum of objs ";
+                    print_objs(p.first);
+                    std::cout << " : " << k << '\n';
+                }
+                if (lower_bounds.at(min_index) < k)
+                    lower_bounds.at(min_index) = k;
             }
         }
     }
@@ -839,6 +967,97 @@ namespace leximaxIST {
             print_sorted_vec(j);
     }
     
+    /* processes a core found by the disjoint cores strategy: updates lb_map and the lower bounds,
+     * removes the variables of the core from inputs_not_sorted and puts them in inputs_to_sort
+     * (or in unit_core_vars, if the core has only one variable)
+     */
+    void Solver::add_disjoint_core(const std::vector<int> &core, std::vector<std::vector<int>> &inputs_not_sorted,
+                                   std::vector<std::vector<int>> &unit_core_vars, std::vector<int> &lower_bounds,
+                                   std::unordered_map<std::vector<bool>, int> &lb_map,
+                                   std::vector<std::vector<int>> &inputs_to_sort)
+    {
+        if (m_verbosity == 2) {
+            std::cout << "c Core size: " << core.size() << '\n';
+            print_core(core);
+        }
+        const std::vector<std::vector<int>> max_vars_vec; // this is empty
+        change_lb_map(0, lower_bounds, core, max_vars_vec, lb_map); // change lb_map and possibly lower_bounds
+        // get the variables in the core
+        std::vector<std::vector<int>> new_inputs(m_num_objectives, std::vector<int>());
+        find_vars_in_core(inputs_not_sorted, core, new_inputs);
+        if (core.size() == 1) {
+            const int j (m_var_info[core.at(0)].index); // index of the objective function in this core
+            unit_core_vars.at(j).push_back(core.at(0));
+            m_var_info[core.at(0)].role = _OBJ_UNIT_CORE_;
+        }
+        else {
+            // add to inputs_to_sort
+            for (int j (0); j < m_num_objectives; ++j)
+                inputs_to_sort.at(j).insert(inputs_to_sort.at(j).end(), new_inputs.at(j).begin(), new_inputs.at(j).end());
+        }
+        if (m_verbosity == 2)
+            print_lower_bounds(lower_bounds);
+    }
+    
+    /* finds disjoint cores of the ith objective alone, i.e. only the variables of the ith objective are assumed,
+     * with a SAT solver of its own, so that it can run in parallel with the other objectives
+     * cores is set to the cores in the order they were found, and model to the model of the last SAT call
+     * if the SAT solver is interrupted, it returns and model is empty
+     */
+    void Solver::objective_cores(int i, std::vector<std::vector<int>> &cores, std::vector<int> &model) const
+    {
+        std::unique_ptr<IpasirWrap> solver (new_sat_solver("unsat"));
+        solver->addClauses(m_input_hard);
+        solver->addClauses(m_encoding);
+        std::vector<int> obj_vars (m_objectives.at(i));
+        std::vector<int> assumps;
+        while (true) {
+            assumps.clear();
+            for (int v : obj_vars)
+                assumps.push_back(-v);
+            const int rv (solver->solve(assumps));
+            if (rv == 0) {
+                if (interrupted())
+                    return; // runs in its own thread, so parallel_objective_cores throws Interrupted
+                print_error_msg("SAT Solver Interrupted!");
+                exit(EXIT_FAILURE);
+            }
+            if (rv == 10) {
+                model.swap(solver->model());
+                return;
+            }
+            const std::vector<int> &core (solver->conflict());
+            cores.push_back(core);
+            // the next cores must be disjoint from this one
+            const std::unordered_set<int> core_vars (core.begin(), core.end());
+            obj_vars.erase(std::remove_if(obj_vars.begin(), obj_vars.end(),
+                                          [&core_vars](int v) { return core_vars.count(v) != 0; }), obj_vars.end());
+        }
+    }
+    
+    /* runs objective_cores for all the objectives, using up to m_nb_threads threads
+     * obj_cores.at(i) is set to the cores of the ith objective
+     */
+    void Solver::parallel_objective_cores(std::vector<std::vector<std::vector<int>>> &obj_cores)
+    {
+        obj_cores.assign(m_num_objectives, std::vector<std::vector<int>>());
+        std::vector<std::vector<int>> models (m_num_objectives, std::vector<int>());
+        std::atomic<int> next_obj (0);
+        auto work = [&]() {
+            for (int i (next_obj++); i < m_num_objectives; i = next_obj++)
+                objective_cores(i, obj_cores.at(i), models.at(i));
+        };
+        std::vector<std::thread> threads;
+        for (int t (0); t < std::min(m_nb_threads, m_num_objectives); ++t)
+            threads.emplace_back(work);
+        for (std::thread &t : threads)
+            t.join();
+        if (interrupted())
+            throw Interrupted();
+        for (std::vector<int> &model : models)
+            set_solution(model);
+    }
+    
     /* returns true if it is possible to satisfy all soft clauses, and false otherwise
      * gets disjoint cores and removes the variables from inputs_not_sorted in the cores
      * the sorting networks are generated with the variables from the cores
@@ -846,7 +1065,7 @@ namespace leximaxIST {
      */
     bool Solver::disjoint_cores(std::vector<std::vector<int>> &inputs_not_sorted,
                                  std::vector<std::vector<int>> &unit_core_vars,
-                                 std::vector<int> &lower_bounds, std::unordered_map<int, int> &lb_map)
+                                 std::vector<int> &lower_bounds, std::unordered_map<std::vector<bool>, int> &lb_map)
     {
         bool rv (true);
         if (m_verbosity >= 1)
@@ -854,9 +1073,20 @@ namespace leximaxIST {
         double initial_time (read_cpu_time());
         /* the first m_num_objectives iterations are for finding cores in each obj separately
          * the last iteration is for finding the remaining cores intersecting 
+         * the first ones are independent, so with several threads their cores are found in parallel
          */
+        std::vector<std::vector<std::vector<int>>> obj_cores;
+        if (m_nb_threads > 1 && m_input_hard.retains())
+            parallel_objective_cores(obj_cores);
         std::vector<std::vector<int>> inputs_to_sort(m_num_objectives, std::vector<int>());
         for (int i (0); i <= m_num_objectives; ++i) {
+            if (i < m_num_objectives && !obj_cores.empty()) {
+                for (const std::vector<int> &core : obj_cores.at(i)) {
+                    rv = false;
+                    add_disjoint_core(core, inputs_not_sorted, unit_core_vars, lower_bounds, lb_map, inputs_to_sort);
+                }
+                continue;
+            }
             std::vector<int> assumps;
             if (i == m_num_objectives) {
                 for (const std::vector<int> &obj_vars : inputs_not_sorted) {
@@ -872,33 +1102,7 @@ namespace leximaxIST {
                 print_assumps(assumps);
             while (!call_sat_solver(m_sat_solver, assumps)) {
                 rv = false;
-                std::vector<int> core (m_sat_solver->conflict());
-                if (m_verbosity == 2) {
-                    std::cout << "c Core size: " << core.size() << '\n';
-                    print_core(core);
-                }
-                const std::vector<std::vector<int>> max_vars_vec; // this is empty
-                change_lb_map(0, lower_bounds, core, max_vars_vec, lb_map); // change lb_map and possibly lower_bounds
-                // get the variables in the core
-                std::vector<std::vector<int>> new_inputs(m_num_objectives, std::vector<int>());
-                find_vars_in_core(inputs_not_sorted, core, new_inputs);
-                if (core.size() == 1) {
-                    int j (0); // index of the objective function in this core
-                    while (new_inputs.at(j).empty())
-                        ++j;
-                    unit_core_vars.at(j).push_back(core.at(0));
-                }
-                else {
-                    // add to inputs_to_sort
-                    for (int j (0); j < m_num_objectives; ++j) {
-                        size_t old_size (inputs_to_sort.at(j).size());
-                        inputs_to_sort.at(j).resize(old_size + new_inputs.at(j).size());
-                        for (size_t k (old_size); k < old_size + new_inputs.at(j).size(); ++k)
-                            inputs_to_sort.at(j).at(k) = new_inputs.at(j).at(k - old_size);
-                    }
-                }
-                if (m_verbosity == 2)
-                    print_lower_bounds(lower_bounds);
+                add_disjoint_core(m_sat_solver->conflict(), inputs_not_sorted, unit_core_vars, lower_bounds, lb_map, inputs_to_sort);
                 // rebuild assumptions
                 assumps.clear();
                 if (i == m_num_objectives) {
@@ -944,12 +1148,10 @@ namespace leximaxIST {
         int max_pos (-1);
         // find the max position in max_vars_ith of the variables in the core
         for (int v : core) {
-            // find v in max_vars_ith
-            for (int k (0); k < max_vars_ith.size(); ++k) {
-                if (v == max_vars_ith.at(k)) {
+            if (var_role(v) == _MAX_VAR_ && m_var_info[v].index == (int) i) {
+                const int k (m_var_info[v].pos);
+                if (k < (int) max_vars_ith.size() && v == max_vars_ith.at(k))
                     max_pos = k;
-                    break;
-                }
             }
         }
         if (max_pos == -1) {
@@ -975,89 +1177,50 @@ namespace leximaxIST {
         }
     }
     
-    void set_inputs_sorted(std::vector<std::vector<int>> &inputs_sorted,
-                           const std::vector<std::vector<int>> &objectives,
-                           const std::vector<std::vector<int>> &inputs_not_sorted,
-                           const std::vector<std::vector<int>> &unit_core_vars)
+    // set inputs_sorted to the obj vars of each objective that are in the sorting network, except the unit core vars
+    void Solver::set_inputs_sorted(std::vector<std::vector<int>> &inputs_sorted) const
     {
-        for (size_t i (0); i < objectives.size(); ++i) {
-            inputs_sorted.at(i).resize(objectives.at(i).size() - inputs_not_sorted.at(i).size() - unit_core_vars.at(i).size(), 0);
-            if (inputs_sorted.at(i).size() > 0) {
-                size_t pos (0);
-                for (int v : objectives.at(i)) {
-                    bool found (false);
-                    // find v in inputs_not_sorted. Add to inputs_sorted if it is not there and it is not in unit_core_vars.
-                    for (int v2 : inputs_not_sorted.at(i)) {
-                        if (v == v2) {
-                            found = true;
-                            break;
-                        } 
-                    }
-                    // find v in unit_core_vars
-                    for (int v2 : unit_core_vars.at(i)) {
-                        if (v == v2) {
-                            found = true;
-                            break;
-                        } 
-                    }
-                    // Add v to inputs_sorted if v is not in inputs_not_sorted and v is not in unit_core_vars
-                    if (!found) {
-                        inputs_sorted.at(i).at(pos) = v;
-                        ++pos;
-                    }
-                }
+        for (size_t i (0); i < m_objectives.size(); ++i) {
+            inputs_sorted.at(i).clear();
+            for (int v : m_objectives.at(i)) {
+                if (var_role(v) == _OBJ_SORTED_)
+                    inputs_sorted.at(i).push_back(v);
             }
         }
     }
     
-    /* set lb_map with all the keys and set the lower bounds to 0
-     * for example, the lower bound of f1 + f2 corresponds to the key 12
-     * the lower bound of f1 corresponds to the key 1
-     * the lower bound of f2 + f3 corresponds to the key 23
+    /* core_rebuild: the encoding clauses are guarded by an activation literal, assumed in every SAT call
+     * when the sorting networks are rebuilt, the previous encoding is retired by adding the negation of its literal
+     * (which satisfies its clauses), so the same SAT solver, with its learnt clauses, is used until the end
      */
-    void Solver::initialise_lb_map(std::unordered_map<int, int> &lb_map, int nb_objs) const
+    void Solver::new_activation()
     {
-        std::vector<int> main_set;
-        for (int j (1); j <= nb_objs; ++j)
-            main_set.push_back(j);
-        if (m_verbosity == 2)
-            std::cout << "c Initialise lb_map - Combinations:\n";
-        for (int j (1); j <= nb_objs; ++j) { // combinations of 1, 2, ..., nb_objs objectives
-            std::vector<std::vector<int>> set_of_combs;
-            std::vector<int> comb;
-            combinations(set_of_combs, main_set, comb, j);
-            for (const std::vector<int> &c : set_of_combs) {
-                if (m_verbosity == 2)
-                    std::cout << "c ";
-                int key (0);
-                for (int k : c) {
-                    key = key * 10 + k;
-                    if (m_verbosity == 2)
-                        std::cout << k << ' ';
-                }
-                if (m_verbosity == 2)
-                    std::cout << '\n';
-                lb_map.insert(std::make_pair(key, 0));
-            }
+        if (m_activation != 0) {
+            m_sat_solver->addClause(-m_activation);
+            m_sat_solver->melt(m_activation);
         }
+        m_activation = fresh();
+        m_sat_solver->freeze(m_activation);
     }
     
     void Solver::optimise_core_guided()
     {
         IpasirWrap *solver (m_sat_solver);
-        if (m_opt_mode == "core_rebuild") {
-            solver = new IpasirWrap();
-            solver->addClauses(m_input_hard);
-        }
+        int nb_rebuilds (0);
+        if (m_opt_mode == "core_rebuild")
+            new_activation();
         std::vector<int> lower_bounds (m_num_objectives, 0);
-        std::unordered_map<int, int> lb_map; // map for the lower bounds of the obj funcs
-        initialise_lb_map(lb_map, m_num_objectives);
+        // lower bounds of the sums of the obj funcs, for each set of objs intersected by the cores
+        std::unordered_map<std::vector<bool>, int> lb_map;
         std::vector<std::vector<int>> unit_core_vars (m_num_objectives, std::vector<int>());
         std::vector<std::vector<int>> max_vars_vec (m_num_objectives, std::vector<int>());
         std::vector<std::vector<int>> inputs_not_sorted (m_num_objectives, std::vector<int>());
         std::vector<int> assumps;
-        for (int j (0); j < m_num_objectives; ++j)
+        for (int j (0); j < m_num_objectives; ++j) {
             inputs_not_sorted.at(j) = m_objectives.at(j);
+            for (size_t pos (0); pos < m_objectives.at(j).size(); ++pos)
+                set_var_info(m_objectives.at(j).at(pos), _OBJ_UNSORTED_, j, pos, pos);
+        }
         if (m_disjoint_cores && (m_opt_mode != "core_static")) {
             if (disjoint_cores(inputs_not_sorted, unit_core_vars, lower_bounds, lb_map))
                 return;
@@ -1069,8 +1232,6 @@ namespace leximaxIST {
         if ((m_opt_mode == "core_static") || m_disjoint_cores) {
             generate_max_vars(0, max_vars_vec);
             componentwise_OR(0, max_vars_vec.at(0));
-            if (m_opt_mode == "core_rebuild")
-                solver->addClauses(m_encoding); // add the encoding to the solver
         }
         if (m_verbosity >= 1)
             print_snet_info();
@@ -1089,8 +1250,6 @@ namespace leximaxIST {
                 encode_relaxation(i);
                 generate_max_vars(i, max_vars_vec);
                 componentwise_OR(i, max_vars_vec.at(i));
-                if (m_opt_mode == "core_rebuild")
-                    solver->addClauses(m_encoding);
                 gen_assumps(lower_bounds, max_vars_vec, inputs_not_sorted, assumps);
             }
             while (!call_sat_solver(solver, assumps)) {
@@ -1140,12 +1299,15 @@ namespace leximaxIST {
                             merge_core_guided(inputs_to_sort, unit_core_vars);
                         if (m_opt_mode == "core_rebuild") {
                             m_encoding.clear();
-                            reset_id_count(); // since some variables have been deleted
+                            new_activation(); // the new encoding replaces the previous one
+                            // the clauses of the previous encodings are removed from time to time
+                            if (++nb_rebuilds % rebuilds_per_simplify == 0)
+                                solver->simplify();
                         }
                         if (m_opt_mode == "core_rebuild" || m_opt_mode == "core_rebuild_incr") {
                             // rebuild the sorting networks
                             std::vector<std::vector<int>> inputs_sorted (m_num_objectives, std::vector<int>());
-                            set_inputs_sorted(inputs_sorted, m_objectives, inputs_not_sorted, unit_core_vars);
+                            set_inputs_sorted(inputs_sorted);
                             for (int j (0); j < m_num_objectives; ++j) {
                                 if (m_opt_mode == "core_rebuild" || !inputs_to_sort.at(j).empty()) {
                                     // do not rebuild only if incremental and there are no new variables to add
@@ -1160,23 +1322,23 @@ namespace leximaxIST {
                             generate_max_vars(j, max_vars_vec);
                             componentwise_OR(j, max_vars_vec.at(j));
                         }
-                        if (m_opt_mode == "core_rebuild") { // create a new sat solver and add clauses
-                            delete solver;
-                            solver = new IpasirWrap();
-                            solver->addClauses(m_input_hard);
-                            solver->addClauses(m_encoding);
-                        }
                         if (m_verbosity >= 1)
                             print_snet_info();
                     }
                 }
                 if (m_verbosity >= 1)
                     print_lower_bounds(lower_bounds);
+                if (m_shared != nullptr)
+                    share_lower_bound(i, lower_bounds.at(i));
                 gen_assumps(lower_bounds, max_vars_vec, inputs_not_sorted, assumps);
             }
+            if (i != m_num_objectives - 1)
+                solver->simplify(); // between the minimisations of two maxima
+        }
+        if (m_activation != 0) {
+            m_sat_solver->melt(m_activation);
+            m_activation = 0;
         }
-        if (m_opt_mode == "core_rebuild")
-            delete solver;
     }
 
 }/* namespace leximaxIST */
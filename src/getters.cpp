@@ -1,6 +1,7 @@
 #include <leximaxIST_Solver.h>
 #include <vector>
 #include <iostream>
+#include <mutex>
 
 namespace leximaxIST {
 
@@ -13,6 +14,14 @@ namespace leximaxIST {
 
     int Solver::nVars() const { return m_id_count; }
     
+    // role of var in m_var_info, _NO_ROLE_ if it is not an objective or maximum variable
+    int Solver::var_role(int var) const
+    {
+        if (var <= 0 || var >= (int) m_var_info.size())
+            return _NO_ROLE_;
+        return m_var_info[var].role;
+    }
+    
     char Solver::get_status() const
     {
         return m_status; 
@@ -23,6 +32,7 @@ namespace leximaxIST {
         std::vector<int> assignment;
         if (m_status == 'u' || m_status == '?')
             return assignment;
+        std::lock_guard<std::mutex> lock (m_solution_mutex); // the solver may be running in another thread
         assignment.resize(m_input_nb_vars + 1);
         for (int j (0); j <= m_input_nb_vars; ++j) {
             assignment.at(j) = m_solution.at(j);
@@ -50,6 +60,7 @@ namespace leximaxIST {
     std::vector<int> Solver::get_objective_vector() const
     {
         std::vector<int> objective_vector;
+        std::lock_guard<std::mutex> lock (m_solution_mutex); // the solver may be running in another thread
         if (!m_solution.empty()) {
             for (const std::vector<int> &obj_func : m_objectives) {
                 int obj_value (0);
@@ -26,11 +26,28 @@ namespace leximaxIST {
         return i_str;
     }
     
-    void print_lb_map(const std::unordered_map<int, int> &lb_map)
+    // prints the indexes (starting at 1) of the objs in the set, for example 1 3 4
+    void print_objs(const std::vector<bool> &objs)
+    {
+        bool first (true);
+        for (size_t j (0); j < objs.size(); ++j) {
+            if (objs.at(j)) {
+                if (!first)
+                    std::cout << ' ';
+                std::cout << j + 1;
+                first = false;
+            }
+        }
+    }
+    
+    void print_lb_map(const std::unordered_map<std::vector<bool>, int> &lb_map)
     {
         std::cout << "c -------------- lb_map --------------\n";
-        for (const std::pair<int, int> &p : lb_map)
-            std::cout << "c " << p.first << " : " << p.second << '\n';
+        for (const std::pair<const std::vector<bool>, int> &p : lb_map) {
+            std::cout << "c ";
+            print_objs(p.first);
+            std::cout << " : " << p.second << '\n';
+        }
         std::cout << "c ------------------------------------\n";
     }
     
@@ -198,7 +215,10 @@ namespace leximaxIST {
     {
         for (int i (0); i < m_num_objectives; ++i) {
             std::cout << "c " << ordinal(i + 1) << " Sorting Network: ";
-            std::cout << m_snet_info.at(i).first << " wires and " << m_snet_info.at(i).second << " comparators\n";
+            std::cout << m_snet_info.at(i).first << " wires and " << m_snet_info.at(i).second << " comparators";
+            if (m_snet_select)
+                std::cout << " (" << m_sorted_vecs.at(i).size() << " outputs)";
+            std::cout << '\n';
         }
     }
     
@@ -229,7 +249,7 @@ namespace leximaxIST {
     }
 
     // leadingStr can be "c ", to print comments, or e.g. "100 " to print weights
-    void Solver::print_clause(std::ostream &output, const Clause &clause, const std::string &leadingStr) const
+    void Solver::print_clause(std::ostream &output, ClauseRef clause, const std::string &leadingStr) const
     {
         output << leadingStr;
         for (int lit : clause)
@@ -246,17 +266,17 @@ namespace leximaxIST {
     void Solver::print_hard_clauses(std::ostream &output) const
     {
         size_t weight (m_soft_clauses.size() + 1);
-        for (const Clause &cl : m_input_hard) {
+        for (ClauseRef cl : m_input_hard) {
             output << weight << " ";
             print_clause(output, cl);
         }
-        for (const Clause &cl : m_encoding) {
+        for (ClauseRef cl : m_encoding) {
             output << weight << " ";
             print_clause(output, cl);
         }
     }
 
-    void Solver::print_pb_constraint(const Clause &cl, std::ostream &output) const
+    void Solver::print_pb_constraint(ClauseRef cl, std::ostream &output) const
     {
         int num_negatives(0);
         for (int literal : cl) {
@@ -268,12 +288,12 @@ namespace leximaxIST {
         output << " >= " << 1 - num_negatives << ";\n";
     }
 
-    void Solver::print_lp_constraint(const Clause &cl, std::ostream &output) const
+    void Solver::print_lp_constraint(ClauseRef cl, std::ostream &output) const
     {
         int num_negatives(0);
         size_t nb_vars_in_line (0);
         for (size_t j (0); j < cl.size(); ++j) {
-            int literal (cl.at(j));
+            int literal (cl[j]);
             bool sign = literal > 0;
             if (!sign)
                 ++num_negatives;
@@ -340,53 +360,54 @@ namespace leximaxIST {
         output << " = " << i << '\n';
     }*/
     
-    void Solver::print_sorted_true() const
+    /* the solution only has the input variables (see IpasirWrap::set_projection), so the values of the
+     * encoding variables are read from the SAT solver, right after a call that found a model
+     */
+    void Solver::print_sorted_true(IpasirWrap *solver) const
     {
-        if (!m_solution.empty()){
-            std::cout << "c Sorted vecs true variables:" << '\n';
-            int j = 0;
-            for (const std::vector<int> &sorted_vec : m_sorted_vecs) {
-                std::cout << "c Sorted vec " << j << ": ";
-                for (int var : sorted_vec) {
-                    if (m_solution.at(var) > 0)
+        std::cout << "c Sorted vecs true variables:" << '\n';
+        int j = 0;
+        for (const std::vector<int> &sorted_vec : m_sorted_vecs) {
+            std::cout << "c Sorted vec " << j << ": ";
+            for (int var : sorted_vec) {
+                if (solver->value(var) > 0)
+                    std::cout << var << ' ';
+            }
+            std::cout << '\n';
+            ++j;
+        }
+        j = 1;
+        for (const std::vector<std::vector<int>> &sorted_relax_vecs : m_sorted_relax_collection) {
+            std::cout << "c Sorted Relax Vecs true variables of iteration " << j << ":" << '\n';
+            int k (0);
+            for (const std::vector<int> &sorted_relax : sorted_relax_vecs) {
+                std::cout << "c Sorted Relax vec " << k << ": ";
+                for (int var : sorted_relax) {
+                    if (solver->value(var) > 0)
                         std::cout << var << ' ';
                 }
                 std::cout << '\n';
-                ++j;
-            }
-            j = 1;
-            for (const std::vector<std::vector<int>> &sorted_relax_vecs : m_sorted_relax_collection) {
-                std::cout << "c Sorted Relax Vecs true variables of iteration " << j << ":" << '\n';
-                int k (0);
-                for (const std::vector<int> &sorted_relax : sorted_relax_vecs) {
-                    std::cout << "c Sorted Relax vec " << k << ": ";
-                    for (int var : sorted_relax) {
-                        if (m_solution[var] > 0)
-                            std::cout << var << ' ';
-                    }
-                    std::cout << '\n';
-                    ++k;
-                }
-                ++j;
+                ++k;
             }
+            ++j;
         }
     }
     
     // prints solution to std output in a similar format to the MaxSAT output format
-    void Solver::print_solution() const 
+    void Solver::print_solution(std::ostream &os) const 
     {
         // print solution status
-        std::cout << "s ";
+        os << "s ";
         if (m_status == 's')
-            std::cout << "SATISFIABLE\n";
+            os << "SATISFIABLE\n";
         if (m_status == 'u') {
-            std::cout << "UNSATISFIABLE\n";
+            os << "UNSATISFIABLE\n";
             return;
         }
         if (m_status == 'o')
-            std::cout << "OPTIMUM FOUND\n";
+            os << "OPTIMUM FOUND\n";
         if (m_status == '?') {
-            std::cout << "UNKNOWN\n";
+            os << "UNKNOWN\n";
             return;
         }
         size_t i (1);
@@ -397,7 +418,7 @@ namespace leximaxIST {
                 line += std::to_string(solution.at(i)) + ' '; // to string ???
                 ++i;
             }
-            std::cout << line << '\n';
+            os << line << '\n';
         }
     }
 
@@ -4,7 +4,9 @@
 #include <string>
 #include <iostream>
 #include <algorithm> // std::sort
+#include <mutex>
 #include <climits>
+#include <cmath>
 #include <cstdlib>
 #include <sys/types.h>
 #include <unistd.h>
@@ -13,15 +15,18 @@ namespace leximaxIST {
     
     bool descending_order (int i, int j);
     
+    size_t weighted_totalizer_size(const std::vector<int> &weights, size_t begin, size_t end,
+                                   std::vector<int> &sums, size_t limit);
+    
     // set_of_clauses can be m_input_hard for input hard clauses or m_encoding for encoding hard clauses
-    void Solver::add_clause(const Clause &cl, std::vector<Clause> &set_of_clauses)
+    void Solver::add_clause(ClauseRef cl, ClauseSet &set_of_clauses)
     {
         if (cl.empty()) {
             print_error_msg("Empty hard clause");
             exit(EXIT_FAILURE);
         }
         update_id_count(cl);
-        set_of_clauses.push_back(cl);
+        set_of_clauses.add(cl);
         if (m_verbosity == 2)
             print_clause(std::cout, cl, "c ");
     }
@@ -29,8 +34,12 @@ namespace leximaxIST {
     // this is public, one can use it to add input hard clauses
     void Solver::add_hard_clause(const Clause &cl)
     {
+        if (m_buffer_vars >= 0) {
+            add_clause(cl, m_input_hard);
+            return;
+        }
         if (m_sat_solver == nullptr)
-            m_sat_solver = new IpasirWrap();
+            m_sat_solver = new_sat_solver();
         add_clause(cl, m_input_hard);
         m_sat_solver->addClause(cl);
         // update status - if unsat it remains unsat, otherwise set to unknown
@@ -38,31 +47,33 @@ namespace leximaxIST {
             m_status = '?';
     }
     
-    void Solver::add_clause_enc(const Clause &cl)
+    void Solver::add_clause_enc(ClauseRef cl)
     {
         add_clause(cl, m_encoding);
-        // In 'core-rebuild' we create a new ipasir solver everytime the sorting networks grow
-        // is this really necessary ?  maybe I can remove the if
-        if (m_opt_mode != "core-rebuild")
+        // in 'core_rebuild' the clauses only hold while the activation literal of the encoding is assumed
+        if (m_activation == 0)
             m_sat_solver->addClause(cl);
+        else
+            m_sat_solver->addClause(cl, -m_activation);
     }
 
+    // the literals are kept in an array on the stack, so that no memory is allocated for the clause
     void Solver::add_clause(int l)
     {
-        const Clause cl {l};
-        add_clause_enc(cl);
+        const int cl[] {l};
+        add_clause_enc(ClauseRef(cl, cl + 1));
     }
     
     void Solver::add_clause(int l1, int l2)
     {
-        const Clause cl {l1, l2};
-        add_clause_enc(cl);
+        const int cl[] {l1, l2};
+        add_clause_enc(ClauseRef(cl, cl + 2));
     }
     
     void Solver::add_clause(int l1, int l2, int l3)
     {
-        const Clause cl {l1, l2, l3};
-        add_clause_enc(cl);
+        const int cl[] {l1, l2, l3};
+        add_clause_enc(ClauseRef(cl, cl + 3));
     }
     
     int Solver::fresh()
@@ -75,22 +86,112 @@ namespace leximaxIST {
         return ++m_id_count; 
     }
     
+    int Solver::fresh_vars(int n)
+    {
+        if (n <= 0) {
+            print_error_msg("Solver::fresh_vars - argument '" + std::to_string(n) + "' is not positive!");
+            exit(EXIT_FAILURE);
+        }
+        if (m_id_count > INT_MAX - n) {
+            print_error_msg("The number of variables exceeded INT_MAX");
+            exit(EXIT_FAILURE);
+        }
+        const int first (m_id_count + 1);
+        m_id_count += n;
+        return first;
+    }
+    
+    /* this solver becomes a buffer of the hard clauses of another solver whose variables are 1..nb_vars:
+     * the clauses are kept (in m_input_hard) but not given to a SAT solver, and the fresh variables come after nb_vars
+     */
+    void Solver::set_buffer(int nb_vars)
+    {
+        if (!m_input_hard.empty() || m_num_objectives != 0) {
+            print_error_msg("Solver::set_buffer - must be called before adding clauses!");
+            exit(EXIT_FAILURE);
+        }
+        if (nb_vars < 0) {
+            print_error_msg("Solver::set_buffer - argument '" + std::to_string(nb_vars) + "' is negative!");
+            exit(EXIT_FAILURE);
+        }
+        delete m_sat_solver;
+        m_sat_solver = nullptr;
+        m_input_hard.set_retain(true);
+        m_buffer_vars = nb_vars;
+        m_id_count = nb_vars;
+    }
+    
+    /* adds the hard clauses of buffer (see set_buffer): its variables up to nb_vars are the same in this solver,
+     * and its fresh variables are renumbered to a block of fresh variables of this solver, in the same order
+     */
+    void Solver::add_hard_clauses(const Solver &buffer)
+    {
+        const int nb_vars (buffer.m_buffer_vars);
+        if (nb_vars < 0) {
+            print_error_msg("Solver::add_hard_clauses - the argument is not a clause buffer");
+            exit(EXIT_FAILURE);
+        }
+        if (nb_vars > m_id_count) {
+            print_error_msg("Solver::add_hard_clauses - the buffer has variables that are not of this solver");
+            exit(EXIT_FAILURE);
+        }
+        const int nb_fresh (buffer.m_id_count - nb_vars);
+        const int shift (nb_fresh == 0 ? 0 : fresh_vars(nb_fresh) - nb_vars - 1);
+        Clause cl;
+        for (ClauseRef buffered : buffer.m_input_hard) {
+            cl.clear();
+            for (int lit : buffered) {
+                if (std::abs(lit) <= nb_vars)
+                    cl.push_back(lit);
+                else
+                    cl.push_back(lit > 0 ? lit + shift : lit - shift);
+            }
+            add_hard_clause(cl);
+        }
+    }
+    
     void Solver::reset_file_name()
     {
-        m_file_name = std::to_string(getpid());
+        m_file_name = std::to_string(getpid()) + "_" + std::to_string(m_instance_id);
     }
     
     void Solver::set_opt_mode(const std::string &mode)
     {
         if (mode != "external" && mode != "bin" && mode != "lin_su" &&
             mode != "lin_us" && mode != "core_static" && mode != "core_merge"
-            && mode != "core_rebuild" && mode != "core_rebuild_incr" && mode != "ilp") {
+            && mode != "core_rebuild" && mode != "core_rebuild_incr" && mode != "ilp" && mode != "portfolio") {
             print_error_msg("Invalid optimisation mode: '" + mode + "'");
             exit(EXIT_FAILURE);
         }
         m_opt_mode = mode;
     }
     
+    // the algorithms run by the portfolio mode, each in its own thread
+    void Solver::set_portfolio(const std::vector<std::string> &modes)
+    {
+        if (modes.empty()) {
+            print_error_msg("Solver::set_portfolio - empty portfolio");
+            exit(EXIT_FAILURE);
+        }
+        for (const std::string &mode : modes) {
+            if (mode != "bin" && mode != "lin_su" && mode != "lin_us" && mode != "core_static" &&
+                mode != "core_merge" && mode != "core_rebuild" && mode != "core_rebuild_incr") {
+                print_error_msg("Solver::set_portfolio - invalid optimisation mode in the portfolio: '" + mode + "'");
+                exit(EXIT_FAILURE);
+            }
+        }
+        m_portfolio = modes;
+    }
+    
+    void Solver::set_nb_threads(int n)
+    {
+        if (n < 1) {
+            print_error_msg("Solver::set_nb_threads - argument '" + std::to_string(n) + "' is not positive!");
+            exit(EXIT_FAILURE);
+        }
+        m_nb_threads = n;
+    }
+    
     void Solver::set_approx(const std::string &algorithm)
     {
         if (algorithm != "mss" && algorithm != "gia") {
@@ -177,12 +278,17 @@ namespace leximaxIST {
         if (model.empty())
             return old_obj_vec;
         if (m_solution.empty()) {
-            m_solution.swap(model);
+            {
+                std::lock_guard<std::mutex> lock (m_solution_mutex);
+                m_solution.swap(model);
+            }
             model.clear();
             if (m_verbosity >= 1) {
                 print_time(read_cpu_time(), "c Leximax-better solution found: ");
                 print_obj_vector(new_obj_vec);
             }
+            if (m_shared != nullptr)
+                share_solution(new_obj_vec);
             return new_obj_vec;
         }
         std::vector<int> s_new_obj_vec (new_obj_vec);
@@ -191,12 +297,17 @@ namespace leximaxIST {
         std::sort(s_old_obj_vec.begin(), s_old_obj_vec.end(), descending_order);
         for (size_t j (0); j < s_new_obj_vec.size(); ++j) {
             if (s_new_obj_vec.at(j) < s_old_obj_vec.at(j)) { // model is better
-                m_solution.swap(model);
+                {
+                    std::lock_guard<std::mutex> lock (m_solution_mutex);
+                    m_solution.swap(model);
+                }
                 model.clear();
                 if (m_verbosity >= 1) {
                     print_time(read_cpu_time(), "c Leximax-better solution found: ");
                     print_obj_vector(new_obj_vec);
                 }
+                if (m_shared != nullptr)
+                    share_solution(new_obj_vec);
                 return new_obj_vec;
             }
             else if (s_new_obj_vec.at(j) > s_old_obj_vec.at(j)) { // m_solution is better
@@ -207,18 +318,7 @@ namespace leximaxIST {
         return old_obj_vec; // the obj vecs are leximax-equal
     }
     
-    // set m_id_count to the maximum id without the encoding - m_input_nb_vars + obj vars
-    void Solver::reset_id_count()
-    {
-        m_id_count = m_input_nb_vars;
-        for (const std::vector<int> &objective : m_objectives) {
-            m_id_count += objective.size();
-        }
-        if (m_verbosity == 2)
-            std::cout << "c Resetting m_id_count... m_id_count = " << m_id_count << '\n';
-    }
-    
-    void Solver::update_id_count(const Clause &clause)
+    void Solver::update_id_count(ClauseRef clause)
     {
         for (int lit : clause) {
             int var( lit < 0 ? -lit : lit );
@@ -227,8 +327,15 @@ namespace leximaxIST {
         }
     }
     
-    // add an objective function in the form of a set of soft clauses (so the goal is to minimise clause falsification)
-    void Solver::add_soft_clauses(const std::vector<Clause> &soft_clauses)
+    void Solver::set_var_info(int var, int role, int index, int pos, int slot)
+    {
+        if (var >= (int) m_var_info.size())
+            m_var_info.resize(var + 1, VarInfo {_NO_ROLE_, -1, -1, -1});
+        m_var_info[var] = VarInfo {role, index, pos, slot};
+    }
+    
+    // makes room for a new objective function, returns its index
+    int Solver::new_objective(const std::vector<Clause> &soft_clauses)
     {
         if (soft_clauses.empty()) {
             print_error_msg("In function leximaxIST::Solver::add_soft_clauses, empty objective function");
@@ -238,33 +345,112 @@ namespace leximaxIST {
         // set m_snet_info to a vector of (0,0) pairs
         m_snet_info.resize(m_num_objectives, std::pair(0,0));
         m_objectives.resize(m_num_objectives);
+        m_obj_presorted.resize(m_num_objectives, false);
         m_sorted_vecs.resize(m_num_objectives);
+        m_snet_inputs.resize(m_num_objectives);
         // set m_all_relax_vars to a vector of empty lists
         m_all_relax_vars.resize(m_num_objectives);
         // set m_sorted_relax_collection to a vector of empty vectors
         m_sorted_relax_collection.resize(m_num_objectives);
         for (const Clause &soft_clause : soft_clauses)
             update_id_count(soft_clause);
+        // update status - if optimum found then it becomes sat, otherwise status is not changed
+        if (m_status == 'o')
+            m_status = 's';
+        return m_num_objectives - 1;
+    }
+    
+    // returns a fresh variable that is true iff the soft clause is falsified
+    int Solver::relax_soft_clause(const Clause &soft_clause)
+    {
+        // neg fresh_var implies soft_clause
+        int fresh_var (fresh());
+        Clause hard_clause (soft_clause); // copy constructor
+        hard_clause.push_back(fresh_var);
+        add_hard_clause(hard_clause);
+        // other implication: soft_clause implies neg fresh_var
+        for (const int soft_lit : soft_clause) {
+            Clause cl {-soft_lit, -fresh_var};
+            add_hard_clause(cl);
+        }
+        return fresh_var;
+    }
+    
+    // add an objective function in the form of a set of soft clauses (so the goal is to minimise clause falsification)
+    void Solver::add_soft_clauses(const std::vector<Clause> &soft_clauses)
+    {
+        const int i (new_objective(soft_clauses)); // position in m_objectives of the current objective
         // convert clause satisfiaction maximisation to minimisation of sum of variables
         if (m_verbosity == 2)
             std::cout << "c ---- Input soft clauses conversion to variables ----\n";
-        int i (m_num_objectives - 1); // position in m_objectives of the current objective
         for (const std::vector<int> &soft_clause : soft_clauses) {
-            // neg fresh_var implies soft_clause
-            int fresh_var (fresh());
-            Clause hard_clause (soft_clause); // copy constructor
+            const int fresh_var (relax_soft_clause(soft_clause));
+            set_var_info(fresh_var, _OBJ_UNSORTED_, i, m_objectives.at(i).size(), m_objectives.at(i).size());
             m_objectives.at(i).push_back(fresh_var);
-            hard_clause.push_back(fresh_var);
-            add_hard_clause(hard_clause);
-            // other implication: soft_clause implies neg fresh_var
-            for (const int soft_lit : soft_clause) {
-                Clause cl {-soft_lit, -fresh_var};
-                add_hard_clause(cl);
+        }
+    }
+    
+    /* add an objective function where the ith soft clause has weight weights[i] (the goal is to minimise
+     * the sum of the weights of the falsified clauses)
+     * instead of repeating the soft clauses, the weighted sum is encoded with a totalizer (see unary_weighted_sum),
+     * whose outputs are already sorted, so the objective does not need a sorting network
+     * the totalizer can be much larger when the weights are diverse, in that case the soft clauses are repeated
+     */
+    void Solver::add_soft_clauses(const std::vector<Clause> &soft_clauses, const std::vector<int> &weights)
+    {
+        if (weights.size() != soft_clauses.size()) {
+            print_error_msg("In function leximaxIST::Solver::add_soft_clauses, the number of weights is not the number of soft clauses");
+            exit(EXIT_FAILURE);
+        }
+        long long total_weight (0);
+        for (int w : weights) {
+            if (w <= 0) {
+                print_error_msg("In function leximaxIST::Solver::add_soft_clauses, weight '" + std::to_string(w) + "' is not positive");
+                exit(EXIT_FAILURE);
             }
+            total_weight += w;
         }
-        // update status - if optimum found then it becomes sat, otherwise status is not changed
-        if (m_status == 'o')
-            m_status = 's';
+        if (total_weight > INT_MAX) {
+            print_error_msg("In function leximaxIST::Solver::add_soft_clauses, the sum of the weights exceeds INT_MAX");
+            exit(EXIT_FAILURE);
+        }
+        if (total_weight == (long long) weights.size()) { // unweighted
+            add_soft_clauses(soft_clauses);
+            return;
+        }
+        /* size of the repetition: the relaxation of the repeated soft clauses and a sorting network on
+         * total_weight wires, with about n*log(n)*(log(n) + 1)/4 comparators of 3 or 6 clauses
+         */
+        size_t repetition_size (0);
+        for (size_t j (0); j < soft_clauses.size(); ++j)
+            repetition_size += weights.at(j) * (soft_clauses.at(j).size() + 1);
+        const size_t log_weight (std::ceil(std::log2(total_weight)));
+        const size_t comparator_size (m_half_comparators ? 3 : 6);
+        repetition_size += comparator_size * total_weight * log_weight * (log_weight + 1) / 4;
+        std::vector<int> sums;
+        size_t totalizer_size (weighted_totalizer_size(weights, 0, weights.size(), sums, repetition_size));
+        if (totalizer_size < repetition_size)
+            totalizer_size += 2 * (total_weight - sums.size()); // equivalences of the values the sum can not take
+        if (totalizer_size >= repetition_size) {
+            if (m_verbosity == 2)
+                std::cout << "c ---- Weighted soft clauses repeated according to their weights ----\n";
+            std::vector<Clause> repeated_clauses;
+            for (size_t j (0); j < soft_clauses.size(); ++j)
+                repeated_clauses.insert(repeated_clauses.end(), weights.at(j), soft_clauses.at(j));
+            add_soft_clauses(repeated_clauses);
+            return;
+        }
+        const int i (new_objective(soft_clauses));
+        if (m_verbosity == 2)
+            std::cout << "c ---- Input weighted soft clauses conversion to variables ----\n";
+        std::vector<std::pair<int, int>> terms; // (variable, weight)
+        for (size_t j (0); j < soft_clauses.size(); ++j)
+            terms.emplace_back(relax_soft_clause(soft_clauses.at(j)), weights.at(j));
+        std::vector<int> &objective (m_objectives.at(i));
+        unary_weighted_sum(terms, objective);
+        for (size_t pos (0); pos < objective.size(); ++pos)
+            set_var_info(objective.at(pos), _OBJ_UNSORTED_, i, pos, pos);
+        m_obj_presorted.at(i) = true;
     }
         
     void Solver::set_gia_incr(bool v) { m_gia_incr = v; }
@@ -312,4 +498,47 @@ namespace leximaxIST {
     
     void Solver::set_disjoint_cores(bool v) { m_disjoint_cores = v; }
     
+    void Solver::set_snet_select(bool v) { m_snet_select = v; }
+    
+    void Solver::set_half_comparators(bool v) { m_half_comparators = v; }
+    
+    void Solver::set_decompose(bool v) { m_decompose = v; }
+    
+    void Solver::set_solution_phases(bool v) { m_solution_phases = v; }
+    
+    // replaces the SAT solver by one of the given backend
+    void Solver::set_sat_backend(const std::string &backend)
+    {
+        if (!m_input_hard.empty() || m_num_objectives != 0) {
+            print_error_msg("Solver::set_sat_backend - must be called before adding clauses!");
+            exit(EXIT_FAILURE);
+        }
+        if (backend != "ipasir" && backend != "cadical") {
+            print_error_msg("Invalid SAT backend: '" + backend + "'");
+            exit(EXIT_FAILURE);
+        }
+#ifdef IPASIR_ONLY
+        if (backend == "cadical") {
+            print_error_msg("The native CaDiCaL backend is not available: leximaxIST was built with IPASIR_ONLY");
+            exit(EXIT_FAILURE);
+        }
+#endif
+        m_sat_backend = backend;
+        delete m_sat_solver;
+        m_sat_solver = new_sat_solver();
+    }
+    
+    /* If v is false, the hard clauses are only given to the SAT solver and are not kept in m_input_hard and m_encoding.
+     * This saves memory, but the algorithms that rebuild the SAT solver or write the problem to a file can not be used.
+     */
+    void Solver::set_retain_clauses(bool v)
+    {
+        if (!m_input_hard.empty() || !m_encoding.empty()) {
+            print_error_msg("Solver::set_retain_clauses - must be called before adding clauses!");
+            exit(EXIT_FAILURE);
+        }
+        m_input_hard.set_retain(v);
+        m_encoding.set_retain(v);
+    }
+    
 }/* namespace leximaxIST */
@@ -15,9 +15,12 @@ namespace leximaxIST {
 
     bool descending_order (int i, int j) { return i > j; }
 
-    // send signal signum to external solver if it is running, and get best solution
+    /* interrupt the SAT solvers, so that optimise and approximate return with the best solution found so far
+     * send signal signum to external solver if it is running, and get best solution
+     */
     int Solver::terminate()
     { // TODO: in the end also do clean up: free dynamically allocated memory
+        m_cancelled = true;
         // TODO MAYBE CHANGE THIS: set m_child_pid = 0 in the beggining of solving and in constructor
         // each time fork() is run you update m_child_pid. What can occur: m_child_pid may be from previous iteration
         // in this case waitpid will fail and say: no child pid. If it fails just return
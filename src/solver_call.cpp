@@ -2,6 +2,7 @@
 #include <leximaxIST_rusage.h>
 #include <leximaxIST_parsing_utils.h>
 #include <leximaxIST_printing.h>
+#include <leximaxIST_SharedState.h>
 #include <IpasirWrap.h>
 #include <zlib.h>
 #include <sys/wait.h>
@@ -17,10 +18,15 @@
 #include <iostream>
 #include <limits> // std::numeric_limits<double>::max()
 #include <vector>
-#include <algorithm> // std::max_element, std::sort
+#include <algorithm> // std::max_element, std::sort, std::shuffle
 #include <cmath> // std::abs()
 #include <sstream>
 #include <cctype>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional> // std::ref
+#include <memory> // std::unique_ptr
 
 namespace leximaxIST {
 
@@ -29,7 +35,7 @@ namespace leximaxIST {
     void Solver::call_ilp_solver(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i)
     {
         // temporary file names
-        const std::string base ("/tmp/" + std::to_string(getpid()) + "_" + std::to_string(i));
+        const std::string base ("/tmp/" + m_file_name + "_" + std::to_string(i));
         const std::string input_file_name (base + ".lp");
         const std::string sol_file_name (base + ".sol");
         m_tmp_files.push_back(input_file_name);
@@ -416,9 +422,9 @@ namespace leximaxIST {
                 out << " " << "+1" << m_multiplication_string << "x" << -neg_var;
             out << ";\n";
         }
-        for (const Clause &cl : m_input_hard)
+        for (ClauseRef cl : m_input_hard)
             print_pb_constraint(cl, out);
-        for (const Clause &cl : m_encoding)
+        for (ClauseRef cl : m_encoding)
             print_pb_constraint(cl, out);
         out.close();
     }
@@ -515,9 +521,9 @@ namespace leximaxIST {
         }
         output << "Subject To\n";
         // print constraints
-        for (const Clause &cl : m_input_hard)
+        for (ClauseRef cl : m_input_hard)
             print_lp_constraint(cl, output);
-        for (const Clause &cl : m_encoding)
+        for (ClauseRef cl : m_encoding)
             print_lp_constraint(cl, output);
         // print all variables after Binaries
         output << "Binaries\n";
@@ -529,7 +535,7 @@ namespace leximaxIST {
     
     void Solver::write_lp_file(const std::vector<ILPConstraint> &constraints, const std::vector<int> &max_vars, int i) const
     {
-        const std::string filename ("/tmp/" + std::to_string(getpid()) + "_" + std::to_string(i) + ".lp");
+        const std::string filename ("/tmp/" + m_file_name + "_" + std::to_string(i) + ".lp");
         std::ofstream os(filename); 
         if (!os) {
             print_error_msg("Could not open '" + filename + "' for writing");
@@ -635,8 +641,9 @@ namespace leximaxIST {
      * remove those variables from todo_vec
      * update assumps
      * update upper_bounds
+     * the values of the soft variables are read from the last model of solver
      */
-    void Solver::mss_add_falsified (IpasirWrap *solver, const std::vector<int> &model, std::vector<std::vector<int>> &mss, std::vector<std::vector<int>> &todo_vec, std::vector<int> &assumps)
+    void Solver::mss_add_falsified (IpasirWrap *solver, std::vector<std::vector<int>> &mss, std::vector<std::vector<int>> &todo_vec, std::vector<int> &assumps)
     {
         std::vector<std::vector<int>> vars_to_add (m_num_objectives); // by objective
         // find all satisfied soft clauses that haven't been added to the mss
@@ -644,7 +651,7 @@ namespace leximaxIST {
             std::vector<int> &todo (todo_vec[j]);
             for (size_t i (0); i < todo.size(); ++i) {
                 int var (todo.at(i));
-                if (model[var] < 0)
+                if (solver->value(var) < 0)
                     vars_to_add.at(j).push_back(i);
             }
         }
@@ -702,25 +709,37 @@ namespace leximaxIST {
         if (m_verbosity >= 1)
             print_mss_enum_info();
         int nb_msses (0);
+        size_t nb_imported (0); // number of blocking clauses imported from the other workers
         std::vector<int> obj_vec (get_objective_vector());
         int best_max (*std::max_element(obj_vec.begin(), obj_vec.end()));
         std::vector<Clause> blocking_cls;
         IpasirWrap *solver (nullptr);
+        std::mt19937 rng (m_mss_seed);
         double initial_time (read_cpu_time());
         while (true) {
+            if (m_shared != nullptr) { // block the MSSes found by all the workers, including this one
+                std::vector<Clause> new_cls;
+                nb_msses = import_blocking_clauses(nb_imported, new_cls);
+                for (const Clause &cl : new_cls) {
+                    if (m_mss_incr)
+                        add_hard_clause(cl);
+                    else
+                        blocking_cls.push_back(cl);
+                }
+            }
             if (m_mss_nb_limit > 0 && nb_msses >= m_mss_nb_limit)
                 break;
-            IpasirWrap new_solver;
+            std::unique_ptr<IpasirWrap> new_solver;
             if (m_mss_incr)
                 solver = m_sat_solver;
             else {
-                solver = &new_solver;
-                solver->addClauses(m_input_hard);
+                new_solver.reset(copy_hard_clauses("sat"));
+                solver = new_solver.get();
                 solver->addClauses(blocking_cls);
             }
             std::vector<std::vector<int>> mss (m_num_objectives);
             solver->set_timeout(m_approx_tout, initial_time);
-            const int rv (mss_linear_search(mss, solver, best_max));
+            const int rv (mss_linear_search(mss, solver, best_max, m_mss_seed == 0 ? nullptr : &rng));
             // remove timeout
             solver->set_timeout(std::numeric_limits<double>::max(), 0);
             if (rv != 10)
@@ -742,12 +761,20 @@ namespace leximaxIST {
                     }
                 }
             }
+            if (m_shared != nullptr) {
+                share_blocking_clause(block_mss);
+                continue;
+            }
             if (m_mss_incr)
                 add_hard_clause(block_mss);
             else
                 blocking_cls.push_back(block_mss);
             ++nb_msses;
         }
+        if (m_shared != nullptr) { // this worker has finished, so the enumeration is over
+            m_shared->stop = true;
+            return;
+        }
         if (m_verbosity == 2) {
             std::cout << "c Blocking clauses:\n";
             for (const Clause &c : blocking_cls) {
@@ -768,24 +795,27 @@ namespace leximaxIST {
      * 20 - unsat means all msses were found
      * 0 - interrupted means timeout reached
      * in the end, variable mss is the sets of chosen satisfied soft clauses, by objective
+     * if rng is not null, the soft clauses of each objective are tested in a random order
      */
-    int Solver::mss_linear_search(std::vector<std::vector<int>> &mss, IpasirWrap *solver, int &best_max)
+    int Solver::mss_linear_search(std::vector<std::vector<int>> &mss, IpasirWrap *solver, int &best_max, std::mt19937 *rng)
     {
         // is there another MSS?
         std::vector<int> assumps;
+        seed_phases(solver);
         int rv (solver->solve());
         if (rv != 10)
             return rv; // UNSAT or interrupted
         // SAT, but the MSS may be empty. If so, all MSSes have been found
-        std::vector<int> model (solver->model()); // copy
         const std::vector<int> &obj_vec (set_solution(solver->model())); // move
         best_max = *std::max_element(obj_vec.begin(), obj_vec.end()); 
         std::vector<std::vector<int>> todo_vec (m_num_objectives);
         for (int i (0); i < m_num_objectives; ++i) {
             const std::vector<int> &objective (m_objectives.at(i));
             todo_vec[i] = objective; // copy assignment
+            if (rng != nullptr)
+                std::shuffle(todo_vec[i].begin(), todo_vec[i].end(), *rng);
         }
-        mss_add_falsified (solver, model, mss, todo_vec, assumps);
+        mss_add_falsified (solver, mss, todo_vec, assumps);
         int nb_calls (1);
         while (true /*stops when obj_index == -1 or if SAT call is interrupted*/) {
             if (m_verbosity == 2)
@@ -795,25 +825,25 @@ namespace leximaxIST {
                 break;
             const int next_var (todo_vec.at(obj_index).at(0));
             assumps.push_back(-next_var);
+            seed_phases(solver);
             const int rv_local = solver->solve(assumps);
             if (rv_local == 0) {
                 rv = 0; // interrupted
                 break;
             }
             if (rv_local == 10) { // SAT
-                model = solver->model(); // copy
                 const std::vector<int> &obj_vec (set_solution(solver->model())); // move
                 best_max = *std::max_element(obj_vec.begin(), obj_vec.end());
-                // add clause to the mss
-                if (!m_mss_incr) {
-                    assumps.pop_back();
-                    solver->addClause(-next_var);
-                }
                 // update mss
                 mss.at(obj_index).push_back(-next_var);
                 // remove next_var from todo (BEFORE mss_add_falsified)
                 erase_from_todo(todo_vec, obj_index, 0);
-                mss_add_falsified (solver, model, mss, todo_vec, assumps);
+                mss_add_falsified (solver, mss, todo_vec, assumps);
+                // add clause to the mss (AFTER mss_add_falsified, which reads the model of solver)
+                if (!m_mss_incr) {
+                    assumps.pop_back();
+                    solver->addClause(-next_var);
+                }
             }
             else { // UNSAT
                 // add clause to the mcs (backbone literals)
@@ -897,25 +927,47 @@ namespace leximaxIST {
     void Solver::approximate()
     {
         double initial_time (read_cpu_time());
+        m_input_nb_vars = m_id_count;
+        // the algorithms only read the values of the input variables (the objective variables included)
+        m_sat_solver->set_projection(m_input_nb_vars);
+        // the non-incremental versions rebuild the SAT solver from the hard clauses
+        if (!m_input_hard.retains() && ((m_approx == "gia" && !m_gia_incr) || (m_approx == "mss" && !m_mss_incr))) {
+            print_error_msg("Non-incremental " + m_approx + " needs the hard clauses, which were not retained");
+            exit(EXIT_FAILURE);
+        }
         // check if problem is satisfiable
-        if (!call_sat_solver(m_sat_solver, {})) {
-            m_status = 'u';
+        try {
+            if (!call_sat_solver(m_sat_solver, {})) {
+                m_status = 'u';
+                return;
+            }
+        }
+        catch (const Interrupted&) { // terminate was called, the status remains UNKNOWN
             return;
         }
         m_status = 's'; // update status to SATISFIABLE
         if (m_approx == "gia") {
             if (m_verbosity >= 1)
                 std::cout << "c Approximating using Guided Improvement Algorithm (GIA)...\n";
-            // encode sorted vectors with sorting network
-            for (int j (0); j < m_num_objectives; ++j)
-                encode_sorted(m_objectives.at(j), j);
-            encode_bounds(0, 0); // upper bound all objs based on the solution given by the SAT solver
-            gia();
+            // the workers of the parallel GIA are copies of the problem, that encode their own sorting networks
+            if (m_nb_threads > 1 && m_input_hard.retains())
+                gia_parallel();
+            else {
+                // encode sorted vectors with sorting network
+                for (int j (0); j < m_num_objectives; ++j)
+                    encode_sorted(m_objectives.at(j), j);
+                encode_bounds(0, 0); // upper bound all objs based on the solution given by the SAT solver
+                gia();
+            }
         }
         else if (m_approx == "mss") {
             if (m_verbosity >= 1)
                 std::cout << "c Approximating using Maximal Satisfiable Subsets...\n";
-            mss_enumerate();
+            // the workers of the parallel enumeration are copies of the problem
+            if (m_nb_threads > 1 && m_input_hard.retains())
+                mss_enumerate_parallel();
+            else
+                mss_enumerate();
         }
         else {
             print_error_msg("Invalid approximation algorithm");
@@ -939,11 +991,17 @@ namespace leximaxIST {
         bool skip (false);
         double initial_time (read_cpu_time());
         while (true /*stops when interrupted or last max can not be improved*/) {
-            IpasirWrap new_solver;
+            if (m_shared != nullptr) { // continue from the progress of the other workers of the parallel GIA
+                if (import_gia_progress(max_index))
+                    skip = false;
+                if (max_index == m_num_objectives)
+                    break;
+            }
+            std::unique_ptr<IpasirWrap> new_solver;
             IpasirWrap *solver (nullptr);
             if (!m_gia_incr) {
-                solver = &new_solver;
-                solver->addClauses(m_input_hard);
+                new_solver.reset(copy_hard_clauses("sat"));
+                solver = new_solver.get();
                 solver->addClauses(m_encoding);
             }
             else
@@ -1006,6 +1064,8 @@ namespace leximaxIST {
         }
         // unset timeout
         m_sat_solver->set_timeout(std::numeric_limits<double>::max(), 0);
+        if (m_shared != nullptr) // this worker has finished, so the approximation is over
+            m_shared->stop = true;
     }
     
     /* adds to unit_clauses the clauses that:
@@ -1155,6 +1215,7 @@ namespace leximaxIST {
                 initial_time = read_cpu_time();
                 std::cout << "c Calling SAT solver...\n";
             }
+            seed_phases(solver);
             rv = solver->solve(assumps);
             if (m_verbosity >= 1)
                 print_time(read_cpu_time() - initial_time, "c SAT call CPU time: ");
@@ -1231,31 +1292,31 @@ namespace leximaxIST {
         std::cout << "c Number of SAT calls: " << nb_calls << '\n';
     }
     
-    void Solver::update_lb(int &lb)
+    // lower bound of the cost given by a core of a SAT call with assumptions in m_soft_clauses, 0 if it gives none
+    int Solver::core_lower_bound(const std::vector<int> &core) const
     {
-        const std::vector<int> &core (m_sat_solver->conflict());
         // get the position in m_soft_clauses of the var with the greatest id in the core
         // NOTE: we assume m_soft_clauses is sorted in increasing order
         for (int pos (m_soft_clauses.size() - 1); pos >= 0; --pos) {
             const int var (std::abs(m_soft_clauses.at(pos)));
-            // try to find var in core
-            bool found (false);
             for (int lit : core) {
-                if (std::abs(lit) == var) {
-                    found = true;
-                    break;
-                }
+                if (std::abs(lit) == var) // the lower bound is pos = size - lb, hence, lb = size - pos
+                    return m_soft_clauses.size() - pos;
             }
-            if (found) { // update lower bound and return
-                // update the lower bound pos = size - lb, hence, lb = size - pos
-                const int new_lb = m_soft_clauses.size() - pos;
-                if (new_lb <= lb) {
-                    print_error_msg("In Solver::update_lb(), lb did not increase");
-                    exit(EXIT_FAILURE);
-                }
-                lb = new_lb;
-                break;
+        }
+        return 0;
+    }
+    
+    void Solver::update_lb(int &lb)
+    {
+        const std::vector<int> &core (m_sat_solver->conflict());
+        const int new_lb (core_lower_bound(core));
+        if (new_lb != 0) {
+            if (new_lb <= lb) {
+                print_error_msg("In Solver::update_lb(), lb did not increase");
+                exit(EXIT_FAILURE);
             }
+            lb = new_lb;
         }
         // check core size. If core size > 1, get the relevant variable and add it as hard
         // cost >= lb means at least lb ones
@@ -1269,6 +1330,26 @@ namespace leximaxIST {
         }
     }
     
+    /* solution-guided search: the SAT solver decides first on the values of the input variables in m_solution
+     * or, if there is no solution yet, on false for the objective variables (only the cadical backend has phases)
+     */
+    void Solver::seed_phases(IpasirWrap *solver) const
+    {
+        if (!m_solution_phases)
+            return;
+        std::lock_guard<std::mutex> lock (m_solution_mutex); // m_solution is replaced by the other searches of search_parallel
+        if (m_solution.empty()) {
+            for (const std::vector<int> &objective : m_objectives) {
+                for (int var : objective)
+                    solver->phase(-var);
+            }
+            return;
+        }
+        const int nb_vars (std::min<int>(m_input_nb_vars, m_solution.size() - 1));
+        for (int var (1); var <= nb_vars; ++var)
+            solver->phase(m_solution.at(var));
+    }
+    
     void Solver::search(int i, int lb, int ub)
     {
         int nb_calls (0);
@@ -1276,6 +1357,15 @@ namespace leximaxIST {
             print_bounds(lb, ub);
         int size (m_soft_clauses.size());
         while (ub != lb) {
+            if (m_shared != nullptr) { // bounds and solutions of the other workers of the portfolio
+                const bool new_lb (import_lower_bound(i, lb));
+                const bool new_ub (import_solution(i, ub));
+                if (new_lb || new_ub) {
+                    if (m_verbosity >= 1)
+                        print_bounds(lb, ub);
+                    continue;
+                }
+            }
             int k;
             if (m_opt_mode == "bin")
                 k = lb + (ub - lb)/2; // floor of half of the interval
@@ -1292,14 +1382,19 @@ namespace leximaxIST {
             if (m_verbosity >= 1)
                 std::cout << "c Calling SAT solver...\n";
             double initial_time (read_cpu_time());
+            seed_phases(m_sat_solver);
             const int rv (m_sat_solver->solve(assumps));
             if (m_verbosity >= 1)
                 print_time(read_cpu_time() - initial_time, "c SAT call CPU time: ");
             if (rv == 0) {
+                if (interrupted())
+                    throw Interrupted(); // terminate was called or another worker of the portfolio has finished
                 print_error_msg("SAT solver interrupted with no timeout!");
                 exit(EXIT_FAILURE);
             }
             if (rv == 10) { // cost <= k
+                if (m_verbosity == 2)
+                    print_sorted_true(m_sat_solver);
                 // get solution and refine upper bound
                 std::vector<int> s_obj_vec (set_solution(m_sat_solver->model()));
                 std::sort (s_obj_vec.begin(), s_obj_vec.end(), descending_order);
@@ -1309,11 +1404,15 @@ namespace leximaxIST {
             else { // cost >= k + 1
                 // inspect core and check if lb can be increased by more than 1
                 update_lb(lb);
+                if (m_shared != nullptr)
+                    share_lower_bound(i, lb);
             }
             ++nb_calls;
             if (m_verbosity >= 1)
                 print_bounds(lb, ub);
         }
+        if (m_shared != nullptr) // the ith maximum is optimal
+            share_lower_bound(i, lb);
         if (m_verbosity >= 1)
             print_nb_sat_calls(nb_calls);
     }
@@ -1335,11 +1434,133 @@ namespace leximaxIST {
         double initial_time;
         if (m_verbosity >= 1)
             initial_time = read_cpu_time();
-        search(i, lb, ub);
+        if (m_nb_threads > 1 && m_shared == nullptr && m_encoding.retains() && lb < ub)
+            search_parallel(i, lb, ub);
+        else
+            search(i, lb, ub);
         if (m_verbosity >= 1)
             print_time(read_cpu_time() - initial_time, "c Minimisation CPU time: ");
     }
     
+    /* the linear SAT-UNSAT, linear UNSAT-SAT and binary searches (m_opt_mode first, as many as m_nb_threads allows)
+     * race to minimise the ith maximum, each in its own thread with its own incremental SAT solver:
+     * the search of m_opt_mode uses m_sat_solver and the others the solvers in m_search_solvers
+     * the bounds are shared, so every search narrows its interval with the bounds found by the others,
+     * and the SAT calls that test a value outside the bounds are interrupted
+     */
+    void Solver::search_parallel(int i, int lb, int ub)
+    {
+        std::vector<std::string> directions {m_opt_mode};
+        for (const std::string mode : {"lin_su", "lin_us", "bin"}) {
+            if ((int) directions.size() < m_nb_threads && mode != m_opt_mode)
+                directions.push_back(mode);
+        }
+        sync_search_solvers(directions);
+        std::vector<IpasirWrap*> solvers {m_sat_solver};
+        solvers.insert(solvers.end(), m_search_solvers.begin(), m_search_solvers.begin() + directions.size() - 1);
+        if (m_verbosity >= 1) {
+            std::cout << "c Concurrent searches: ";
+            for (const std::string &direction : directions)
+                std::cout << direction << ' ';
+            std::cout << '\n';
+            print_bounds(lb, ub);
+        }
+        SearchState state (lb, ub, directions.size());
+        for (size_t t (0); t < solvers.size(); ++t)
+            solvers.at(t)->set_stop(&state.stop.at(t));
+        std::vector<std::thread> threads;
+        for (size_t t (0); t < solvers.size(); ++t)
+            threads.emplace_back(&Solver::search_worker, this, t, std::cref(directions.at(t)), solvers.at(t), i, std::ref(state));
+        for (std::thread &t : threads)
+            t.join();
+        for (IpasirWrap *solver : solvers)
+            solver->set_stop(nullptr);
+        if (state.interrupted)
+            throw Interrupted(); // terminate was called
+        encode_ub_soft(state.ub);
+        if (m_verbosity >= 1)
+            print_nb_sat_calls(state.nb_calls);
+    }
+    
+    // runs in its own thread: search t of search_parallel, in the given direction (lin_su, lin_us or bin)
+    void Solver::search_worker(int t, const std::string &direction, IpasirWrap *solver, int i, SearchState &state)
+    {
+        const int size (m_soft_clauses.size());
+        std::vector<int> assumps;
+        while (true) {
+            int k;
+            {
+                std::lock_guard<std::mutex> lock (state.mutex);
+                if (state.lb == state.ub || state.interrupted)
+                    return;
+                if (direction == "bin")
+                    k = state.lb + (state.ub - state.lb)/2;
+                else if (direction == "lin_su")
+                    k = state.ub - 1;
+                else
+                    k = state.lb;
+                state.k.at(t) = k;
+                state.stop.at(t) = false;
+            }
+            // y <= k means size - k zeros
+            assumps.assign(m_soft_clauses.begin(), m_soft_clauses.begin() + size - k);
+            seed_phases(solver);
+            const int rv (solver->solve(assumps));
+            std::lock_guard<std::mutex> lock (state.mutex);
+            state.k.at(t) = -1;
+            ++state.nb_calls;
+            if (rv == 0) {
+                if (interrupted()) {
+                    state.interrupted = true;
+                    for (std::atomic<bool> &stop : state.stop)
+                        stop = true;
+                    return;
+                }
+                if (state.stop.at(t))
+                    continue; // k is no longer between the bounds
+                print_error_msg("SAT solver interrupted with no timeout!");
+                exit(EXIT_FAILURE);
+            }
+            if (rv == 10) { // cost <= k
+                std::vector<int> s_obj_vec (set_solution(solver->model()));
+                std::sort (s_obj_vec.begin(), s_obj_vec.end(), descending_order);
+                state.ub = std::min(state.ub, s_obj_vec.at(i));
+            }
+            else { // cost >= k + 1, maybe more according to the core
+                const int lb (std::max(k + 1, core_lower_bound(solver->conflict())));
+                solver->addClause(-m_soft_clauses.at(size - lb)); // only this solver, the others do not need it
+                state.lb = std::max(state.lb, lb);
+            }
+            if (m_verbosity >= 1)
+                std::cout << "c " << direction << ": lb = " << state.lb << " ub = " << state.ub << '\n';
+            for (size_t s (0); s < state.k.size(); ++s) {
+                if (state.k.at(s) != -1 && (state.k.at(s) < state.lb || state.k.at(s) >= state.ub))
+                    state.stop.at(s) = true;
+            }
+        }
+    }
+    
+    /* m_search_solvers gets a SAT solver for each of the directions but the first (the one of m_sat_solver),
+     * with the hard clauses and the encoding clauses, and configured for its direction (see CadicalWrap)
+     * the solvers that already exist only get the encoding clauses added since the previous call
+     */
+    void Solver::sync_search_solvers(const std::vector<std::string> &directions)
+    {
+        const size_t nb_solvers (directions.size() - 1);
+        for (IpasirWrap *solver : m_search_solvers) {
+            for (size_t c (m_search_synced); c < m_encoding.nb_stored(); ++c)
+                solver->addClause(m_encoding[c]);
+        }
+        m_search_synced = m_encoding.nb_stored();
+        while (m_search_solvers.size() < nb_solvers) {
+            const std::string &direction (directions.at(m_search_solvers.size() + 1));
+            IpasirWrap *solver (new_sat_solver(direction == "lin_su" ? "sat" : direction == "lin_us" ? "unsat" : ""));
+            solver->addClauses(m_input_hard);
+            solver->addClauses(m_encoding);
+            m_search_solvers.push_back(solver);
+        }
+    }
+    
     // calls sat solver with assumptions and returns true if sat and false if unsat
     bool Solver::call_sat_solver(IpasirWrap *solver, const std::vector<int> &assumps)
     {
@@ -1357,10 +1578,14 @@ namespace leximaxIST {
         if (m_verbosity >= 1)
             print_time(read_cpu_time() - initial_time, "c SAT call CPU time: ");
         if (rv == 0) {
+            if (interrupted())
+                throw Interrupted(); // terminate was called or another worker of the portfolio has finished
             print_error_msg("SAT Solver Interrupted!");
             exit(EXIT_FAILURE);
         }
         if (rv == 10) {
+            if (m_verbosity == 2)
+                print_sorted_true(solver);
             // get solution and return
             set_solution(solver->model());
             return true;
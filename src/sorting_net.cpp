@@ -1,22 +1,35 @@
 #include <leximaxIST_Solver.h>
 #include <leximaxIST_printing.h>
 #include <leximaxIST_types.h>
+#include <algorithm>
+#include <numeric> // std::iota
 #include <utility>
 #include <vector>
 
 namespace leximaxIST {
 
-    /* a sorting network is a vector with size equal to the number of wires.
-    * Entry i contains the last comparator (in the construction of the sorting network) that connects to wire i.
-    * The comparator is represented as a pair. The first component is the other wire j that the comparator connects to.
-    * The second component is the variable representing
-    * the smallest of the outputs, if i < j
-    * the greatest of the outputs, if i > j.*/
+    /* a sorting network is the sequence of its comparators, in the order of construction (see SNET).
+    * Each comparator is a pair of wires (i, j) with i < j. After the comparator, wire i holds
+    * the smallest of the two values and wire j holds the greatest.
+    * Hence, the outputs are sorted in increasing order: the last wire holds the greatest output.
+    * The comparators are computed first and the clauses are generated afterwards, so that
+    * the comparators that do not reach the outputs we are interested in can be left out (k-selection).
+    * The comparators of each size of sorting network are computed only once (see sort_schedule).
+    */
 
+    /* If m_half_comparators, only the clauses that imply the outputs upwards are encoded (3 per comparator):
+     * an output may be true even if fewer inputs are true, but it is true whenever enough inputs are true.
+     * This is enough because the objectives are only minimised, and the upper bounds (negative outputs)
+     * are still propagated to the inputs.
+     * The lower bounds and the fixed maxima that assert positive outputs (e.g. encode_lb_sorted, fix_max, fix_all)
+     * no longer constrain the inputs, but this does not change the optimum: those constraints are implied by
+     * the previous iterations, and the componentwise OR already only implies the maximum variables upwards.
+     */
     void Solver::encode_max(int var_out_max, int var_in1, int var_in2)
     {
         // encode var_out_max is equivalent to var_in1 OR var_in2
-        add_clause(-var_out_max, var_in1, var_in2);
+        if (!m_half_comparators)
+            add_clause(-var_out_max, var_in1, var_in2);
         add_clause(var_out_max, -var_in1);
         add_clause(var_out_max, -var_in2);
     }
@@ -24,148 +37,385 @@ namespace leximaxIST {
     void Solver::encode_min(int var_out_min, int var_in1, int var_in2)
     {
         // encode var_out_min is equivalent to var_in1 AND var_in2
-        add_clause(-var_out_min, var_in1);
-        add_clause(-var_out_min, var_in2);
+        if (!m_half_comparators) {
+            add_clause(-var_out_min, var_in1);
+            add_clause(-var_out_min, var_in2);
+        }
         add_clause(var_out_min, -var_in1, -var_in2);
     }
 
-    void Solver::insert_comparator(int el1, int el2, const std::vector<int> *objective, SNET &sorting_network)
+    /* wire_vars contains the variable that is currently on each wire
+     * outputs says which of the outputs of the comparator are used: _MIN_OUTPUT_, _MAX_OUTPUT_ or both
+     */
+    void Solver::insert_comparator(int el1, int el2, int outputs, std::vector<int> &wire_vars)
     {
         if (m_verbosity == 2)
             std::cout << "c Inserting comparator between wires " << el1 << " and " << el2 << '\n';
-        // if the entry is empty, then it is the first comparator for that wire
-        int var_in1 = (sorting_network[el1].first == -1) ? objective->at(el1) : sorting_network[el1].second;
-        int var_in2 = (sorting_network[el2].first == -1) ? objective->at(el2) : sorting_network[el2].second;
-        int var_out_min = fresh();
-        int var_out_max = fresh();
-        // encode outputs, if el1 > el2 then el1 is the largest, that is, the or. Otherwise, el1 is the smallest, i.e. the and.
-        encode_max(var_out_max, var_in1, var_in2);
-        encode_min(var_out_min, var_in1, var_in2);
-        std::pair<int,int> comp1 (el2, 0);
-        std::pair<int,int> comp2 (el1, 0);
-        if(el1 > el2)
-            comp1.second = var_out_max;
-        else
-            comp1.second = var_out_min;
-        sorting_network[el1] = comp1;
-        if(el2 > el1)
-            comp2.second = var_out_max;
-        else
-            comp2.second = var_out_min;
-        sorting_network[el2] = comp2;
-    }
-
-    int ceiling_of_half(int number)
-    {
-        // floor
-        int result = number/2;
-        // if number is odd then add 1
-        if(number % 2 != 0)
-            result++;
-        return result;
+        const int var_in1 (wire_vars[el1]);
+        const int var_in2 (wire_vars[el2]);
+        const int var_out_min ((outputs & _MIN_OUTPUT_) ? fresh() : 0);
+        const int var_out_max ((outputs & _MAX_OUTPUT_) ? fresh() : 0);
+        // el1 < el2, so el1 gets the smallest output, that is, the and, and el2 gets the largest, i.e. the or.
+        if (var_out_max != 0) {
+            encode_max(var_out_max, var_in1, var_in2);
+            wire_vars[el2] = var_out_max;
+        }
+        if (var_out_min != 0) {
+            encode_min(var_out_min, var_in1, var_in2);
+            wire_vars[el1] = var_out_min;
+        }
     }
 
-    // returns the number of comparators added to the sorting network by this function
-    int Solver::odd_even_merge(std::pair<std::pair<int,int>,int> seq1, std::pair<std::pair<int,int>,int> seq2, const std::vector<int> *objective, SNET &sorting_network)
+    /* adds to sorting_network the comparators that merge the sorted sequences of wires seq1 and seq2
+     * the wires of seq1 are smaller than the wires of seq2, and each sequence is in increasing order
+     */
+    void odd_even_merge(const std::vector<int> &seq1, const std::vector<int> &seq2, SNET &sorting_network)
     {
-        int nb_comparators (0);
-        int el1;
-        int el2;
-        int size1 = seq1.first.second;
-        int size2 = seq2.first.second;
-        if(size1 == 0 || size2 == 0){
+        const size_t size1 (seq1.size());
+        const size_t size2 (seq2.size());
+        if (size1 == 0 || size2 == 0) {
             // nothing to merge
         }
-        else if(size1 == 1 && size2 == 1){
+        else if (size1 == 1 && size2 == 1) {
             // merge two elements with a single comparator.
-            el1 = seq1.first.first;
-            el2 = seq2.first.first;
-            insert_comparator(el1, el2, objective, sorting_network);
-            ++nb_comparators;
+            sorting_network.emplace_back(seq1.at(0), seq2.at(0));
         }
         else {
-            // merge odd subsequences
-            // size of odd subsequence is the ceiling of half of the size of the original sequence
-            int offset1 = seq1.second;
-            int offset2 = seq2.second;
-            int first1 = seq1.first.first;
-            int first2 = seq2.first.first;
-            std::pair<int,int> p1(first1, ceiling_of_half(size1));
-            std::pair<std::pair<int,int>,int> odd1(p1, 2*offset1);
-            std::pair<int,int> p2(first2, ceiling_of_half(size2));
-            std::pair<std::pair<int,int>,int> odd2(p2, 2*offset2);
-            nb_comparators += odd_even_merge(odd1, odd2, objective, sorting_network);
-            // merge even subsequences
-            // size of even subsequence is the floor of half of the size of the original sequence
-            p1 = std::make_pair(first1 + offset1, size1/2);
-            std::pair<std::pair<int,int>,int> even1(p1, 2*offset1);
-            p2 = std::make_pair(first2 + offset2, size2/2);
-            std::pair<std::pair<int,int>,int> even2(p2, 2*offset2);
-            nb_comparators += odd_even_merge(even1, even2, objective, sorting_network);
-            // comparison-interchange
-            for(int i{2}; i <= size1; i = i + 2){
-                if(i == size1){
-                    // connect last of seq1 to first element of seq2
-                    el1 = first1 + offset1*(size1-1);
-                    el2 = first2;
-                    insert_comparator(el1, el2, objective, sorting_network);
-                    ++nb_comparators;
-                }
-                else{
-                    // connect i-th of seq1 with i+1-th of seq1
-                    el1 = first1 + offset1*(i-1);
-                    el2 = el1 + offset1;
-                    insert_comparator(el1, el2, objective, sorting_network);
-                    ++nb_comparators;
-                }
-            }
-            int init = (size1 % 2 == 0) ? 2 : 1 ;
-            for(int i{init}; i < size2; i = i + 2){
-                    // connect i-th of seq2 with i+1-th of seq2
-                    el1 = first2 + offset2*(i-1);
-                    el2 = el1 + offset2;
-                    insert_comparator(el1, el2, objective, sorting_network); 
-                    ++nb_comparators;
+            // odd subsequences have the 1st, 3rd, ... elements and even subsequences the 2nd, 4th, ...
+            std::vector<int> odd1, even1, odd2, even2;
+            for (size_t i (0); i < size1; ++i)
+                (i % 2 == 0 ? odd1 : even1).push_back(seq1.at(i));
+            for (size_t i (0); i < size2; ++i)
+                (i % 2 == 0 ? odd2 : even2).push_back(seq2.at(i));
+            odd_even_merge(odd1, odd2, sorting_network);
+            odd_even_merge(even1, even2, sorting_network);
+            // comparison-interchange: 2nd with 3rd, 4th with 5th, ... of the concatenation of seq1 and seq2
+            for (size_t i (1); i + 1 < size1 + size2; i += 2) {
+                const int el1 (i < size1 ? seq1.at(i) : seq2.at(i - size1));
+                const int el2 (i + 1 < size1 ? seq1.at(i + 1) : seq2.at(i + 1 - size1));
+                sorting_network.emplace_back(el1, el2);
             }
         }
-        return nb_comparators;
     }
 
-    // returns the number of comparators of the sorting network
-    int Solver::encode_network(const std::pair<int,int> elems_to_sort, const std::vector<int> *objective, SNET &sorting_network)
+    /* sorting networks with the least known number of comparators for up to 16 inputs (optimal in size)
+     * the ith network sorts the wires 0, 1, ..., i + 1, each line is a layer of comparators that can be done in parallel
+     * the networks for 14 and 15 inputs are the one for 16 inputs without the greatest wires
+     */
+    const std::vector<SNET>& small_networks()
     {
-        /* in the case the sorting network only has one element (this is important for the core-guided algorithm)
-        * we must set the pair to (0, objective->at(0))
-        * the first element is not used and it needs to be different from -1
-        * the second element is the output variable of that wire
-        */
-        if (sorting_network.size() == 1) {
-            sorting_network.at(0).first = 0;
-            sorting_network.at(0).second = objective->at(0);
-            return 0;
+        static const std::vector<SNET> networks {
+            // 2 inputs, 1 comparator
+            {{0, 1}},
+            // 3 inputs, 3 comparators
+            {{0, 2},
+             {0, 1},
+             {1, 2}},
+            // 4 inputs, 5 comparators
+            {{0, 2}, {1, 3},
+             {0, 1}, {2, 3},
+             {1, 2}},
+            // 5 inputs, 9 comparators
+            {{0, 3}, {1, 4},
+             {0, 2}, {1, 3},
+             {0, 1}, {2, 4},
+             {1, 2}, {3, 4},
+             {2, 3}},
+            // 6 inputs, 12 comparators
+            {{0, 5}, {1, 3}, {2, 4},
+             {1, 2}, {3, 4},
+             {0, 3}, {2, 5},
+             {0, 1}, {2, 3}, {4, 5},
+             {1, 2}, {3, 4}},
+            // 7 inputs, 16 comparators
+            {{0, 6}, {2, 3}, {4, 5},
+             {0, 2}, {1, 4}, {3, 6},
+             {0, 1}, {2, 5}, {3, 4},
+             {1, 2}, {4, 6},
+             {2, 3}, {4, 5},
+             {1, 2}, {3, 4}, {5, 6}},
+            // 8 inputs, 19 comparators
+            {{0, 2}, {1, 3}, {4, 6}, {5, 7},
+             {0, 4}, {1, 5}, {2, 6}, {3, 7},
+             {0, 1}, {2, 3}, {4, 5}, {6, 7},
+             {2, 4}, {3, 5},
+             {1, 4}, {3, 6},
+             {1, 2}, {3, 4}, {5, 6}},
+            // 9 inputs, 25 comparators
+            {{0, 3}, {1, 7}, {2, 5}, {4, 8},
+             {0, 7}, {2, 4}, {3, 8}, {5, 6},
+             {0, 2}, {1, 3}, {4, 5}, {7, 8},
+             {1, 4}, {3, 6}, {5, 7},
+             {0, 1}, {2, 4}, {3, 5}, {6, 8},
+             {2, 3}, {4, 5}, {6, 7},
+             {1, 2}, {3, 4}, {5, 6}},
+            // 10 inputs, 29 comparators
+            {{0, 8}, {1, 9}, {2, 7}, {3, 5}, {4, 6},
+             {0, 2}, {1, 4}, {5, 8}, {7, 9},
+             {0, 3}, {2, 4}, {5, 7}, {6, 9},
+             {0, 1}, {3, 6}, {8, 9},
+             {1, 5}, {2, 3}, {4, 8}, {6, 7},
+             {1, 2}, {3, 5}, {4, 6}, {7, 8},
+             {2, 3}, {4, 5}, {6, 7},
+             {3, 4}, {5, 6}},
+            // 11 inputs, 35 comparators
+            {{0, 9}, {1, 6}, {2, 4}, {3, 7}, {5, 8},
+             {0, 1}, {3, 5}, {4, 10}, {6, 9}, {7, 8},
+             {1, 3}, {2, 5}, {4, 7}, {8, 10},
+             {0, 4}, {1, 2}, {3, 7}, {5, 9}, {6, 8},
+             {0, 1}, {2, 6}, {4, 5}, {7, 8}, {9, 10},
+             {2, 4}, {3, 6}, {5, 7}, {8, 9},
+             {1, 2}, {3, 4}, {5, 6}, {7, 8},
+             {2, 3}, {4, 5}, {6, 7}},
+            // 12 inputs, 39 comparators
+            {{0, 8}, {1, 7}, {2, 6}, {3, 11}, {4, 10}, {5, 9},
+             {0, 1}, {2, 5}, {3, 4}, {6, 9}, {7, 8}, {10, 11},
+             {0, 2}, {1, 6}, {5, 10}, {9, 11},
+             {0, 3}, {1, 2}, {4, 6}, {5, 7}, {8, 11}, {9, 10},
+             {1, 4}, {3, 5}, {6, 8}, {7, 10},
+             {1, 3}, {2, 5}, {6, 9}, {8, 10},
+             {2, 3}, {4, 5}, {6, 7}, {8, 9},
+             {4, 6}, {5, 7},
+             {3, 4}, {5, 6}, {7, 8}},
+            // 13 inputs, 45 comparators
+            {{0, 12}, {1, 10}, {2, 9}, {3, 7}, {5, 11}, {6, 8},
+             {1, 6}, {2, 3}, {4, 11}, {7, 9}, {8, 10},
+             {0, 4}, {1, 2}, {3, 6}, {7, 8}, {9, 10}, {11, 12},
+             {4, 6}, {5, 9}, {8, 11}, {10, 12},
+             {0, 5}, {3, 8}, {4, 7}, {6, 11}, {9, 10},
+             {0, 1}, {2, 5}, {6, 9}, {7, 8}, {10, 11},
+             {1, 3}, {2, 4}, {5, 6}, {9, 10},
+             {1, 2}, {3, 4}, {5, 7}, {6, 8},
+             {2, 3}, {4, 5}, {6, 7}, {8, 9},
+             {3, 4}, {5, 6}},
+            // 14 inputs, 51 comparators
+            {{0, 13}, {1, 12}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+             {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {11, 12},
+             {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13},
+             {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9},
+             {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11},
+             {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13},
+             {2, 4}, {3, 6}, {9, 12}, {11, 13},
+             {3, 5}, {6, 8}, {7, 9}, {10, 12},
+             {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+             {6, 7}, {8, 9}},
+            // 15 inputs, 56 comparators
+            {{0, 13}, {1, 12}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+             {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {11, 12},
+             {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13},
+             {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14},
+             {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14},
+             {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14},
+             {2, 4}, {3, 6}, {9, 12}, {11, 13},
+             {3, 5}, {6, 8}, {7, 9}, {10, 12},
+             {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+             {6, 7}, {8, 9}},
+            // 16 inputs, 60 comparators
+            {{0, 13}, {1, 12}, {2, 15}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+             {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {10, 15}, {11, 12},
+             {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13}, {14, 15},
+             {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14}, {13, 15},
+             {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14},
+             {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14},
+             {2, 4}, {3, 6}, {9, 12}, {11, 13},
+             {3, 5}, {6, 8}, {7, 9}, {10, 12},
+             {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+             {6, 7}, {8, 9}}
+        };
+        return networks;
+    }
+
+    /* adds to sorting_network the comparators of an odd-even merge sorting network on the wires
+     * at the leaves of the recursion, with at most 16 wires, the small networks are used instead
+     */
+    void sort_wires(const std::vector<int> &wires, SNET &sorting_network)
+    {
+        if (wires.size() < 2)
+            return; // a single element is already sorted.
+        const std::vector<SNET> &networks (small_networks());
+        if (wires.size() - 2 < networks.size()) {
+            for (const std::pair<int, int> &comp : networks.at(wires.size() - 2))
+                sorting_network.emplace_back(wires.at(comp.first), wires.at(comp.second));
+            return;
         }
-        int nb_comparators (0);
-        int size = elems_to_sort.second;
-        int first_elem = elems_to_sort.first;
-        if(size == 1){
-            // do nothing - a single element is already sorted.
+        const size_t m (wires.size()/2);
+        const std::vector<int> seq1 (wires.begin(), wires.begin() + m);
+        const std::vector<int> seq2 (wires.begin() + m, wires.end());
+        // recursively sort the first m elements and the remaining elements
+        sort_wires(seq1, sorting_network);
+        sort_wires(seq2, sorting_network);
+        // merge the sorted m elements and the sorted remaining elements
+        odd_even_merge(seq1, seq2, sorting_network);
+    }
+
+    /* adds to sorting_network the comparators of a k-selection network on the wires
+     * (simplified cardinality network): each half selects its k greatest elements and only those are merged
+     * returns the wires of the k greatest outputs in increasing order
+     */
+    std::vector<int> select_wires(const std::vector<int> &wires, size_t k, SNET &sorting_network)
+    {
+        if (wires.size() <= k) {
+            sort_wires(wires, sorting_network);
+            return wires;
         }
-        if(size > 1){
-            int m = size/2;
-            int n = size - m;
-            std::pair<int,int> split1(first_elem, m);
-            std::pair<int,int> split2(first_elem + m, n);
-            // recursively sort the first m elements and the last n elements
-            nb_comparators += encode_network(split1, objective, sorting_network);
-            nb_comparators += encode_network(split2, objective, sorting_network);
-            // merge the sorted m elements and the sorted n elements
-            std::pair<std::pair<int,int>,int> seq1(split1,1);
-            std::pair<std::pair<int,int>,int> seq2(split2,1);
-            nb_comparators += odd_even_merge(seq1, seq2, objective, sorting_network);
+        const size_t m (wires.size()/2);
+        const std::vector<int> seq1 (wires.begin(), wires.begin() + m);
+        const std::vector<int> seq2 (wires.begin() + m, wires.end());
+        const std::vector<int> &greatest1 (select_wires(seq1, k, sorting_network));
+        const std::vector<int> &greatest2 (select_wires(seq2, k, sorting_network));
+        odd_even_merge(greatest1, greatest2, sorting_network);
+        std::vector<int> merged (greatest1);
+        merged.insert(merged.end(), greatest2.begin(), greatest2.end());
+        return std::vector<int>(merged.end() - k, merged.end());
+    }
+
+    /* sets schedule to the comparators of sorting_network that reach the output wires
+     * and, for each of them, which of its outputs are used
+     */
+    void make_schedule(const SNET &sorting_network, const std::vector<int> &output_wires, size_t nb_wires, Schedule &schedule)
+    {
+        // go backwards from the outputs, marking the wires whose current value is used
+        std::vector<bool> used_wires (nb_wires, false);
+        for (int wire : output_wires)
+            used_wires.at(wire) = true;
+        std::vector<int> used (sorting_network.size(), 0);
+        for (size_t c (sorting_network.size()); c-- > 0;) {
+            const std::pair<int, int> &comp (sorting_network.at(c));
+            if (used_wires.at(comp.first))
+                used.at(c) |= _MIN_OUTPUT_;
+            if (used_wires.at(comp.second))
+                used.at(c) |= _MAX_OUTPUT_;
+            if (used.at(c) != 0) // both inputs are needed
+                used_wires.at(comp.first) = used_wires.at(comp.second) = true;
         }
+        for (size_t c (0); c < sorting_network.size(); ++c) {
+            if (used.at(c) != 0) {
+                schedule.min_wires.push_back(sorting_network.at(c).first);
+                schedule.max_wires.push_back(sorting_network.at(c).second);
+                schedule.outputs.push_back(used.at(c));
+            }
+        }
+        schedule.output_wires = output_wires;
+    }
+
+    /* the comparators only depend on the number of inputs and outputs, not on the variables
+     * so they are computed once and kept in m_sort_schedules, to be reused by every objective of the same size
+     * nb_outputs is 0 or >= nb_inputs for a complete sorting network, otherwise it is a k-selection network
+     */
+    const Schedule& Solver::sort_schedule(size_t nb_inputs, size_t nb_outputs)
+    {
+        if (nb_outputs == 0 || nb_outputs > nb_inputs)
+            nb_outputs = nb_inputs;
+        const std::pair<size_t, size_t> key (nb_inputs, nb_outputs);
+        auto it (m_sort_schedules.find(key));
+        if (it != m_sort_schedules.end())
+            return it->second;
+        std::vector<int> wires (nb_inputs);
+        std::iota(wires.begin(), wires.end(), 0);
+        SNET sorting_network;
+        std::vector<int> output_wires;
+        if (nb_outputs == nb_inputs) {
+            sort_wires(wires, sorting_network);
+            output_wires = wires;
+        }
+        else
+            output_wires = select_wires(wires, nb_outputs, sorting_network);
+        Schedule &schedule (m_sort_schedules[key]);
+        make_schedule(sorting_network, output_wires, nb_inputs, schedule);
+        return schedule;
+    }
+
+    /* same as sort_schedule for the merging network of two sorted sequences, but it is not kept:
+     * the first sequence is the sorted vector that grows with each merge (see merge_core_guided),
+     * so a size is practically never merged twice
+     */
+    void Solver::merge_schedule(size_t size1, size_t size2, size_t nb_outputs, Schedule &schedule) const
+    {
+        const size_t nb_wires (size1 + size2);
+        if (nb_outputs == 0 || nb_outputs > nb_wires)
+            nb_outputs = nb_wires;
+        std::vector<int> wires (nb_wires);
+        std::iota(wires.begin(), wires.end(), 0);
+        const std::vector<int> seq1 (wires.begin(), wires.begin() + size1);
+        const std::vector<int> seq2 (wires.begin() + size1, wires.end());
+        SNET sorting_network;
+        odd_even_merge(seq1, seq2, sorting_network);
+        wires.erase(wires.begin(), wires.end() - nb_outputs);
+        make_schedule(sorting_network, wires, nb_wires, schedule);
+    }
+
+    /* encodes the comparators of the schedule, in a single pass
+     * wire_vars are the variables on each wire before the network and output_vars is set to the outputs
+     * returns the number of comparators encoded
+     */
+    int Solver::encode_schedule(const Schedule &schedule, std::vector<int> &wire_vars, std::vector<int> &output_vars)
+    {
+        const size_t nb_comparators (schedule.outputs.size());
+        for (size_t c (0); c < nb_comparators; ++c)
+            insert_comparator(schedule.min_wires[c], schedule.max_wires[c], schedule.outputs[c], wire_vars);
+        const std::vector<int> &output_wires (schedule.output_wires);
+        output_vars.resize(output_wires.size());
+        for (size_t j (0); j < output_wires.size(); ++j)
+            output_vars[j] = wire_vars[output_wires[j]];
         return nb_comparators;
     }
-    
+
+    /* sorts the inputs and sets outputs to the sorted variables, in increasing order
+     * if nb_outputs > 0, only the nb_outputs greatest outputs are encoded (k-selection)
+     * returns the number of comparators of the sorting network
+     */
+    int Solver::encode_network(const std::vector<int> &inputs, size_t nb_outputs, std::vector<int> &outputs)
+    {
+        const Schedule &schedule (sort_schedule(inputs.size(), nb_outputs));
+        std::vector<int> wire_vars (inputs);
+        return encode_schedule(schedule, wire_vars, outputs);
+    }
+
+    /* merges the sorted sequences sorted1 and sorted2 and sets outputs to the merged sequence
+     * if nb_outputs > 0, only the nb_outputs greatest outputs are encoded (k-selection)
+     * returns the number of comparators of the merging network
+     */
+    int Solver::encode_merge(const std::vector<int> &sorted1, const std::vector<int> &sorted2,
+                             size_t nb_outputs, std::vector<int> &outputs)
+    {
+        Schedule schedule;
+        merge_schedule(sorted1.size(), sorted2.size(), nb_outputs, schedule);
+        std::vector<int> wire_vars (sorted1);
+        wire_vars.insert(wire_vars.end(), sorted2.begin(), sorted2.end());
+        return encode_schedule(schedule, wire_vars, outputs);
+    }
+
+    /* in k-selection mode, returns the number of greatest outputs of the sorting networks that can be used,
+     * that is, the upper bound on the 1st maximum given by the current solution plus one
+     * returns 0 (all the outputs are used) if not in k-selection mode or if there is no solution yet
+     */
+    size_t Solver::snet_nb_outputs() const
+    {
+        if (!m_snet_select || m_solution.empty())
+            return 0;
+        const std::vector<int> &obj_vec (get_objective_vector());
+        return *std::max_element(obj_vec.begin(), obj_vec.end()) + 1;
+    }
+
+    /* in k-selection mode, the ith sorting network might only have some of the greatest outputs
+     * if the bound grows and more outputs are needed, encode a larger selection network on the same inputs
+     * the clauses of the old network remain valid, they refer to the same inputs
+     */
+    void Solver::extend_sorted(int i, size_t nb_outputs)
+    {
+        std::vector<int> &sorted_vec (m_sorted_vecs.at(i));
+        const std::vector<int> &inputs (m_snet_inputs.at(i));
+        if (!m_snet_select || sorted_vec.size() >= inputs.size())
+            return; // the sorting network is complete
+        if (nb_outputs != 0 && sorted_vec.size() >= nb_outputs)
+            return;
+        if (m_verbosity >= 1) {
+            std::cout << "c Extending the " << ordinal(i + 1) << " sorting network from ";
+            std::cout << sorted_vec.size() << " to " << std::min(nb_outputs, inputs.size()) << " outputs\n";
+        }
+        m_snet_info.at(i).second += encode_network(inputs, nb_outputs, sorted_vec);
+    }
+
     /* Create a sorting network to sort the obj_vars
      * Merge this sorting network with the old sorting network - the outputs are initially in sorted_vec
      * sorted_vec is changed and set to the outputs of the new (larger) sorting network.
@@ -177,48 +427,37 @@ namespace leximaxIST {
             if (obj_vars.size() > 0) {
                 if (m_verbosity >= 1)
                     std::cout << "c Increasing the " << ordinal(obj_index + 1) << " sorting network...\n";
-                // Create a sorting network to sort the obj_vars
-                SNET sort_new_vars(obj_vars.size(), {-1,-1});
-                const std::pair<int,int> elems_to_sort(0, obj_vars.size());
-                if (m_verbosity == 2)
-                    std::cout << "c Sorting the new variables\n";
-                // update sorting network info - nb wires and comparators
-                m_snet_info.at(obj_index).second += encode_network(elems_to_sort, &obj_vars, sort_new_vars);
-                m_snet_info.at(obj_index).first += obj_vars.size();
-                // Merge
-                // the first old_size entries are equal to the old sorting network
                 std::vector<int> &sorted_vec = m_sorted_vecs.at(obj_index);
                 // remove unit_core_vars from the end of sorted_vec
                 for (size_t k (0); k < unit_core_vars.at(obj_index).size(); ++k)
                     sorted_vec.pop_back();
-                const size_t old_size (sorted_vec.size());
-                SNET new_sort_net(old_size + obj_vars.size(), {-1,-1});
-                for (size_t i (0); i < old_size; ++i) {
-                    /* the first of the pair is the wire that is connected to i, through the last comparator
-                    * in this case we don't know, so we put 0.
-                    * we can put any value as long as it is different from -1.
-                    * -1 is used for the case there is no comparator connecting wire i.
-                    */
-                    new_sort_net.at(i).first = 0;
-                    // the second of the pair is the variable associated with the output of the last comparator of wire i.
-                    new_sort_net.at(i).second = sorted_vec.at(i);
+                if (m_obj_presorted.at(obj_index)) { // no sorting network is needed
+                    sorted_vec.insert(sorted_vec.end(), obj_vars.begin(), obj_vars.end());
+                    sort_presorted(sorted_vec);
+                    m_snet_info.at(obj_index).first += obj_vars.size();
+                    add_unit_core_vars(unit_core_vars, obj_index);
+                    continue;
                 }
-                // the last obj_vars.size() entries are equal to sort_new_vars
-                for (size_t i (old_size); i < old_size + obj_vars.size(); ++i) {
-                    new_sort_net.at(i) = sort_new_vars.at(i - old_size);
+                const size_t nb_outputs (snet_nb_outputs());
+                if (m_snet_select) {
+                    extend_sorted(obj_index, nb_outputs);
+                    std::vector<int> &inputs (m_snet_inputs.at(obj_index));
+                    inputs.insert(inputs.end(), obj_vars.begin(), obj_vars.end());
                 }
-                const std::pair<int, int> p1 (0, old_size);
-                const std::pair<int, int> p2 (old_size, obj_vars.size());
-                const std::pair<std::pair<int, int>, int> seq1 (p1, 1); // ((first wire, number of elements), offset)
-                const std::pair<std::pair<int, int>, int> seq2 (p2, 1);
+                // Create a sorting network to sort the obj_vars
+                if (m_verbosity == 2)
+                    std::cout << "c Sorting the new variables\n";
+                std::vector<int> sorted_new_vars;
+                // update sorting network info - nb wires and comparators
+                m_snet_info.at(obj_index).second += encode_network(obj_vars, nb_outputs, sorted_new_vars);
+                m_snet_info.at(obj_index).first += obj_vars.size();
+                // Merge
                 if (m_verbosity == 2)
                     std::cout << "c Merging the sorting networks\n";
-                // Since the sorting network has comparators connecting all wires, hence the nullptr. It is not used.
-                m_snet_info.at(obj_index).second += odd_even_merge(seq1, seq2, nullptr, new_sort_net); // also, update m_snet_info
-                // set sorted_vec to the outputs of new_sort_net
-                sorted_vec.resize(old_size + obj_vars.size());
-                for (size_t i (0); i < old_size + obj_vars.size(); ++i)
-                    sorted_vec.at(i) = new_sort_net.at(i).second;
+                std::vector<int> merged;
+                m_snet_info.at(obj_index).second += encode_merge(sorted_vec, sorted_new_vars, nb_outputs, merged);
+                // set sorted_vec to the outputs of the merged network
+                sorted_vec.swap(merged);
                 add_unit_core_vars(unit_core_vars, obj_index);
             }
         }